@@ -24,12 +24,14 @@
 **********************************************************************************/
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <iomanip>
 #include <ios>
+#include <type_traits>
 #include <utility>
 #ifdef __USE_MOCKRANDOM__
 #include "test/unittest/mockrandom.h"
@@ -48,9 +50,66 @@ namespace IsaacRNG {
   const std::size_t kRandSize = 1 << kRandSizeBits;
   const std::size_t RANDOM_SEED_SIZE = kRandSize;  // alias for use in user programs
 
+  // Tag selecting lazy seeding, e.g. Isaac(kLazySeed, key, keylen). The key is only stored, and
+  // randinit() runs when the first value is drawn, so engines that are never used never pay for
+  // it. The values drawn are exactly those an eagerly seeded engine gives.
+  struct LazySeed {};
+  constexpr LazySeed kLazySeed{};
+
+  class Isaac;
+  class IsaacBulkSeeder;
+  class IsaacPoolEngine;
+  class SeedCache;
+  class SnapshotIsaac;
+  template <class Store>
+  class SeekableIsaac;
+
+  // Hook consulted by Isaac::seed(const char*, size_t) so that an expanded state can be reused
+  // instead of recomputed. Implemented by SeedCache (see isaac_seed_cache.h); nothing is
+  // installed unless that is enabled.
+  class SeedExpansionCache {
+   public:
+    virtual ~SeedExpansionCache() {}
+    virtual bool fetch(const char* key, std::size_t keylen, Isaac& into) = 0;
+    virtual void store(const char* key, std::size_t keylen, const Isaac& from) = 0;
+  };
+
+  namespace detail {
+    // true for types with a SeedSequence-style generate(first, last) that can fill a uint32_t
+    // range, which keeps the seed sequence overloads away from random_device, engines and
+    // containers
+    template <class Sseq, class = void>
+    struct IsSeedSeq : std::false_type {};
+    template <class Sseq>
+    struct IsSeedSeq<Sseq, decltype(void(std::declval<Sseq&>().generate(std::declval<uint32_t*>(), std::declval<uint32_t*>())))>
+        : std::true_type {};
+
+    template <class Sseq, class Self>
+    using EnableIfSeedSeq =
+        typename std::enable_if<IsSeedSeq<Sseq>::value && !std::is_same<typename std::decay<Sseq>::type, Self>::value>::type;
+  }  // namespace detail
+
+  inline std::atomic<SeedExpansionCache*>& activeSeedCache() {
+    static std::atomic<SeedExpansionCache*> cache(nullptr);
+    return cache;
+  }
+
   class Isaac {
    public:
+    friend class IsaacBulkSeeder;
+    friend class IsaacPoolEngine;
+    friend class SeedCache;
+    friend class SnapshotIsaac;
+    template <class Store>
+    friend class SeekableIsaac;
+
     friend std::ostream& operator<<(std::ostream& os, const Isaac& isc) {
+      if (isc.pending) {
+        // print the state the key expands to, which is what an eager engine would show
+        Isaac expanded(isc);
+        expanded.settle();
+        return os << expanded;
+      }
       {
         Isaac::FormatSaver saver(os);
         os << std::setbase(10) << std::left;
@@ -64,17 +123,32 @@ namespace IsaacRNG {
       is >> isc.randa >> isc.randb >> isc.randc;
       is >> isc.randcnt;
       for (size_t i = 0; i < kRandSize; i++) is >> isc.randrsl[i];
+      isc.pending = false;
       return is;
     }
     Isaac() : Isaac(static_cast<uint32_t*>(nullptr), 0) {}
     Isaac(const uint32_t* const seedArr, const std::size_t seedlen) : randrsl(new uint32_t[kRandSize]) { seed(seedArr, seedlen); }
     Isaac(const char* const seedArr, const std::size_t seedlen) : randrsl(new uint32_t[kRandSize]) { seed(seedArr, seedlen); }
     Isaac(std::random_device& rd) : randrsl(new uint32_t[kRandSize]) { seed(rd); }
+    template <class Sseq, class = detail::EnableIfSeedSeq<Sseq, Isaac>>
+    explicit Isaac(Sseq& q) : randrsl(new uint32_t[kRandSize]) { seed(q); }
+    explicit Isaac(LazySeed) : Isaac(kLazySeed, static_cast<uint32_t*>(nullptr), 0) {}
+    Isaac(LazySeed, const uint32_t* const seedArr, const std::size_t seedlen) : randrsl(new uint32_t[kRandSize]) {
+      seed(kLazySeed, seedArr, seedlen);
+    }
+    Isaac(LazySeed, const char* const seedArr, const std::size_t seedlen) : randrsl(new uint32_t[kRandSize]) {
+      seed(kLazySeed, seedArr, seedlen);
+    }
+    Isaac(LazySeed, std::random_device& rd) : randrsl(new uint32_t[kRandSize]) { seed(kLazySeed, rd); }
+    template <class Sseq, class = detail::EnableIfSeedSeq<Sseq, Isaac>>
+    Isaac(LazySeed, Sseq& q) : randrsl(new uint32_t[kRandSize]) { seed(kLazySeed, q); }
     Isaac(const Isaac& isa) : randrsl(new uint32_t[kRandSize]) {
       randa = isa.randa;
       randb = isa.randb;
       randc = isa.randc;
       randcnt = isa.randcnt;
+      pending = isa.pending;
+      std::copy(isa.randmem, isa.randmem + kRandSize, randmem);
       std::copy(isa.randrsl, isa.randrsl + kRandSize, randrsl);
     }
     Isaac(Isaac&& isa) noexcept
@@ -82,7 +156,10 @@ namespace IsaacRNG {
           randb(std::exchange(isa.randb, 0)),
           randc(std::exchange(isa.randc, 0)),
           randcnt(std::exchange(isa.randcnt, 0)),
-          randrsl(std::exchange(isa.randrsl, nullptr)) {}
+          randrsl(std::exchange(isa.randrsl, nullptr)),
+          pending(std::exchange(isa.pending, false)) {
+      std::copy(isa.randmem, isa.randmem + kRandSize, randmem);
+    }
 
     ~Isaac() { delete[] randrsl; }
     Isaac& operator=(const Isaac& isa) {
@@ -91,6 +168,8 @@ namespace IsaacRNG {
         randb = isa.randb;
         randc = isa.randc;
         randcnt = isa.randcnt;
+        pending = isa.pending;
+        std::copy(isa.randmem, isa.randmem + kRandSize, randmem);
         std::copy(isa.randrsl, isa.randrsl + kRandSize, randrsl);
       }
       return *this;
@@ -101,6 +180,8 @@ namespace IsaacRNG {
         randb = std::exchange(isa.randb, 0);
         randc = std::exchange(isa.randc, 0);
         randcnt = std::exchange(isa.randcnt, 0);
+        pending = std::exchange(isa.pending, false);
+        std::copy(isa.randmem, isa.randmem + kRandSize, randmem);
         delete[] randrsl;
         randrsl = std::exchange(isa.randrsl, nullptr);
       }
@@ -109,47 +190,104 @@ namespace IsaacRNG {
     void seed() { seed(static_cast<uint32_t*>(nullptr), 0); }
 
     void seed(const uint32_t* const seedArr, const std::size_t seedlen) {
-      std::fill(randrsl, randrsl + kRandSize, 0);
-      if (seedArr != nullptr) {
-        std::size_t tlen = std::min(seedlen, kRandSize);
-        std::copy(seedArr, seedArr + tlen, randrsl);
-      }
+      loadKey(seedArr, seedlen);
       randinit(true);
     }
 
     void seed(const char* const seedArr, const std::size_t seedlen) {
-      std::fill(randrsl, randrsl + kRandSize, 0);
-      if (seedArr != nullptr) {
-        std::size_t tlen = std::min(seedlen, kRandSize * sizeof(uint32_t));
-        std::memcpy(reinterpret_cast<char*>(randrsl), seedArr, tlen);
-      }
+      const std::size_t tlen = keyBytes(seedArr, seedlen);
+      SeedExpansionCache* const cache = activeSeedCache().load(std::memory_order_acquire);
+      if (cache != nullptr && cache->fetch(seedArr, tlen, *this)) return;
+
+      loadKey(seedArr, tlen);
       randinit(true);
+
+      if (cache != nullptr) cache->store(seedArr, tlen, *this);
     }
 
     void seed(std::random_device& rd) {
-      std::generate(randrsl, randrsl + kRandSize, [&rd]() -> uint32_t { return static_cast<uint32_t>(rd()); });
+      loadKey(rd);
       randinit(true);
     }
 
+    // the seed sequence writes the whole result block, which is then expanded as usual
+    template <class Sseq, class = detail::EnableIfSeedSeq<Sseq, Isaac>>
+    void seed(Sseq& q) {
+      q.generate(randrsl, randrsl + kRandSize);
+      randinit(true);
+    }
+
+    // Lazy forms of the above: only the key is stored. The seed expansion cache is not
+    // consulted, as there is no expansion to save until the first draw.
+    void seed(LazySeed) { seed(kLazySeed, static_cast<uint32_t*>(nullptr), 0); }
+
+    void seed(LazySeed, const uint32_t* const seedArr, const std::size_t seedlen) {
+      loadKey(seedArr, seedlen);
+      defer();
+    }
+
+    void seed(LazySeed, const char* const seedArr, const std::size_t seedlen) {
+      loadKey(seedArr, keyBytes(seedArr, seedlen));
+      defer();
+    }
+
+    void seed(LazySeed, std::random_device& rd) {
+      loadKey(rd);
+      defer();
+    }
+
+    template <class Sseq, class = detail::EnableIfSeedSeq<Sseq, Isaac>>
+    void seed(LazySeed, Sseq& q) {
+      q.generate(randrsl, randrsl + kRandSize);
+      defer();
+    }
+
     void seed(const Isaac& isa) {
       if (this != &isa) {
         randa = isa.randa;
         randb = isa.randb;
         randc = isa.randc;
         randcnt = isa.randcnt;
+        pending = isa.pending;
+        std::copy(isa.randmem, isa.randmem + kRandSize, randmem);
         std::copy(isa.randrsl, isa.randrsl + kRandSize, randrsl);
       }
     }
 
+    // a lazily seeded engine starts with an empty result block, so its expansion happens in the
+    // refill branch and costs later draws nothing
     uint32_t rand() {
       if (randcnt-- == 0) {
-        isaac();
+        refill();
         randcnt = kRandSize - 1;
       }
       return randrsl[randcnt];
     }
 
+    // fill dest with the next n values, exactly as n successive calls to rand() would, but
+    // copying whole runs out of the result block rather than going through rand() per value
+    void generate(uint32_t* dest, std::size_t n) {
+      while (n > 0) {
+        if (randcnt == 0) {
+          refill();
+          randcnt = kRandSize;
+        }
+        std::size_t take = std::min(n, static_cast<std::size_t>(randcnt));
+        std::reverse_copy(randrsl + randcnt - take, randrsl + randcnt, dest);
+        randcnt -= static_cast<uint32_t>(take);
+        dest += take;
+        n -= take;
+      }
+    }
+
+    // a lazily seeded engine compares as the state its key expands to
     bool operator==(const Isaac& rhs) {
+      settle();
+      if (rhs.pending) {
+        Isaac expanded(rhs);
+        expanded.settle();
+        return *this == expanded;
+      }
       return randcnt == rhs.randcnt && randa == rhs.randa && randb == rhs.randb && randc == rhs.randc &&
              std::equal(randrsl, randrsl + kRandSize, rhs.randrsl);
     }
@@ -158,6 +296,7 @@ namespace IsaacRNG {
 
     std::string dump() {
       std::ostringstream outStr;
+      settle();
 
       outStr << std::setbase(16);
       outStr.fill('0');
@@ -187,13 +326,59 @@ namespace IsaacRNG {
     }
 
    private:
-    void isaac() {
-      uint32_t a, b, x, y, *m, *mm, *m2, *r, *mend;
+    void isaac() { isaac(randmem, randrsl, randa, randb, randc); }
+
+    // next result block, expanding the stored key instead if a lazy seed is still pending
+    void refill() {
+      if (pending)
+        randinit(true);
+      else
+        isaac();
+    }
+
+    // bring a lazily seeded engine to the state eager seeding would have left it in
+    void settle() {
+      if (pending) randinit(true);
+    }
+
+    // the seed key goes in randrsl, zero padded, for randinit() to expand
+    void loadKey(const uint32_t* const seedArr, const std::size_t seedlen) {
+      std::fill(randrsl, randrsl + kRandSize, 0);
+      if (seedArr != nullptr) {
+        std::size_t tlen = std::min(seedlen, kRandSize);
+        std::copy(seedArr, seedArr + tlen, randrsl);
+      }
+    }
+
+    // tlen as returned by keyBytes()
+    void loadKey(const char* const seedArr, const std::size_t tlen) {
+      std::fill(randrsl, randrsl + kRandSize, 0);
+      if (tlen > 0) std::memcpy(reinterpret_cast<char*>(randrsl), seedArr, tlen);
+    }
+
+    void loadKey(std::random_device& rd) {
+      std::generate(randrsl, randrsl + kRandSize, [&rd]() -> uint32_t { return static_cast<uint32_t>(rd()); });
+    }
+
+    static std::size_t keyBytes(const char* const seedArr, const std::size_t seedlen) {
+      return seedArr != nullptr ? std::min(seedlen, kRandSize * sizeof(uint32_t)) : 0;
+    }
+
+    // Leave the key unexpanded, with an empty result block so that the first draw refills.
+    // randmem is cleared so that copies and stream input never read it uninitialised.
+    void defer() {
+      std::fill(randmem, randmem + kRandSize, 0);
+      randa = randb = randc = 0;
+      randcnt = 0;
+      pending = true;
+    }
+
+    // one refill of the result block r from the state held in mm, ra, rb and rc
+    static void isaac(uint32_t* const mm, uint32_t* r, uint32_t& ra, uint32_t& rb, uint32_t& rc) {
+      uint32_t a, b, x, y, *m, *m2, *mend;
 
-      mm = randmem;
-      r = randrsl;
-      a = randa;
-      b = randb + (++randc);
+      a = ra;
+      b = rb + (++rc);
       for (m = mm, mend = m2 = m + (kRandSize / 2); m < mend;) {
         rngstep(a << 13, a, b, mm, m, m2, r, x, y);
         rngstep(a >> 6, a, b, mm, m, m2, r, x, y);
@@ -206,8 +391,8 @@ namespace IsaacRNG {
         rngstep(a << 2, a, b, mm, m, m2, r, x, y);
         rngstep(a >> 16, a, b, mm, m, m2, r, x, y);
       }
-      randb = b;
-      randa = a;
+      rb = b;
+      ra = a;
     }
 
     void randinit(const bool flag) {
@@ -278,21 +463,22 @@ namespace IsaacRNG {
 
       isaac();
       randcnt = kRandSize;
+      pending = false;
     }
 
-    uint32_t ind(uint32_t* mm, uint32_t x) {
+    static uint32_t ind(uint32_t* mm, uint32_t x) {
       return *reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(mm) + (x & ((kRandSize - 1) << 2)));
     }
 
-    void rngstep(uint32_t mixit, uint32_t& a, uint32_t& b, uint32_t*& mm, uint32_t*& m, uint32_t*& m2, uint32_t*& r, uint32_t& x,
-                 uint32_t& y) {
+    static void rngstep(uint32_t mixit, uint32_t& a, uint32_t& b, uint32_t* const& mm, uint32_t*& m, uint32_t*& m2, uint32_t*& r,
+                        uint32_t& x, uint32_t& y) {
       x = *m;
       a = (a ^ (mixit)) + *(m2++);
       *(m++) = y = ind(mm, x) + a + b;
       *(r++) = b = ind(mm, y >> kRandSizeBits) + x;
     }
 
-    void mix(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d, uint32_t& e, uint32_t& f, uint32_t& g, uint32_t& h) {
+    static void mix(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d, uint32_t& e, uint32_t& f, uint32_t& g, uint32_t& h) {
       a ^= b << 11;
       d += a;
       b += c;
@@ -324,6 +510,7 @@ namespace IsaacRNG {
     uint32_t randcnt;
     // uint32_t randrsl[kRandSize];
     uint32_t* randrsl;
+    bool pending = false;  // randrsl holds a key that randinit() has yet to expand
 
     class FormatSaver {
      public:
@@ -0,0 +1,317 @@
+#ifndef __ISAAC_ALIAS_H__
+#define __ISAAC_ALIAS_H__
+
+/**********************************************************************************
+
+  Walker/Vose alias-method sampler for discrete distributions, drawing from
+  Isaac or IsaacEngine output. Tables are built in O(n), optionally on several
+  threads, and a draw costs one table lookup.
+
+  Weights are quantised so that every column of the table holds exactly 2^32
+  units of probability and all pairing is done in exact integer arithmetic.
+  The built table therefore depends only on the weights, never on the number
+  of threads used to build it.
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+  --
+
+  N.B. a C++ compiler capable of generating C++14 compliant
+  code is REQUIRED. g++ 5 will work, although g++ 6.1 or higher
+  is preferred.
+
+**********************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+#include "isaac.h"
+#include "isaac_util.h"
+
+namespace IsaacRNG {
+  // Tables up to this size draw column and threshold from a single word, the column from the
+  // high half of word * n and the threshold fraction from the low half. That leaves at least 16
+  // bits of resolution in each. Larger tables use a separate word for each.
+  const std::size_t kAliasSingleWordMaxSize = std::size_t(1) << 16;
+  const std::size_t kAliasMaxSize = std::size_t(1) << 31;
+  // fixed work unit for the build so that reductions happen in the same order on any number of threads
+  const std::size_t kAliasBuildChunk = std::size_t(1) << 16;
+
+  class AliasTable {
+   public:
+    using result_type = uint32_t;
+
+    // an empty table, to be filled by build() before drawing from it
+    AliasTable() : singleWord(true) {}
+    AliasTable(const double* const weights, const std::size_t n, const unsigned threads = 1) { build(weights, n, threads); }
+    AliasTable(const std::vector<double>& weights, const unsigned threads = 1) { build(weights.data(), weights.size(), threads); }
+    AliasTable(std::initializer_list<double> weights) { build(weights.begin(), weights.size()); }
+
+    // (re)build the table from n non-negative weights, not all zero, on up to threads threads
+    // (0 means one per hardware thread). Throws std::invalid_argument for unusable weights.
+    void build(const double* const weights, const std::size_t n, const unsigned threads = 1) {
+      if (n == 0 || n > kAliasMaxSize) throw std::invalid_argument("AliasTable: size must be in [1, 2^31]");
+
+      const std::size_t chunks = (n + kAliasBuildChunk - 1) / kAliasBuildChunk;
+      auto chunkBegin = [n](const std::size_t c) { return std::min(n, c * kAliasBuildChunk); };
+
+      // Total weight, summed per chunk and then in chunk order. The sum is compensated because
+      // its rounding error is scaled up by n * 2^32 and would otherwise swamp the quantisation.
+      std::vector<double> chunkWeight(chunks), chunkError(chunks);
+      std::vector<char> chunkBad(chunks, 0);
+      detail::parallelFor(chunks, threads, [&](const std::size_t c) {
+        double sum = 0.0, err = 0.0;
+        for (std::size_t i = chunkBegin(c); i < chunkBegin(c + 1); i++) {
+          if (!(weights[i] >= 0.0) || !std::isfinite(weights[i])) chunkBad[c] = 1;
+          compensatedAdd(sum, err, weights[i]);
+        }
+        chunkWeight[c] = sum;
+        chunkError[c] = err;
+      });
+      double total = 0.0, totalError = 0.0;
+      for (std::size_t c = 0; c < chunks; c++) {
+        if (chunkBad[c]) throw std::invalid_argument("AliasTable: weights must be finite and non-negative");
+        compensatedAdd(total, totalError, chunkWeight[c]);
+        compensatedAdd(total, totalError, chunkError[c]);
+      }
+      total += totalError;
+      if (!(total > 0.0) || !std::isfinite(total)) throw std::invalid_argument("AliasTable: weights must have a positive finite sum");
+
+      // quantise to integers summing to exactly n * kColumn
+      const double scale = static_cast<double>(n) * static_cast<double>(kColumn) / total;
+      const uint64_t target = static_cast<uint64_t>(n) * kColumn;
+      std::vector<uint64_t> q(n);
+      std::vector<uint64_t> chunkQ(chunks);
+      std::vector<std::size_t> chunkMax(chunks), chunkPositive(chunks);
+      detail::parallelFor(chunks, threads, [&](const std::size_t c) {
+        uint64_t sum = 0;
+        std::size_t imax = chunkBegin(c), positive = 0;
+        for (std::size_t i = chunkBegin(c); i < chunkBegin(c + 1); i++) {
+          q[i] = static_cast<uint64_t>(std::min(weights[i] * scale, static_cast<double>(target)));
+          sum += q[i];
+          if (weights[i] > 0.0) positive++;
+          if (weights[i] > weights[imax]) imax = i;
+        }
+        chunkQ[c] = sum;
+        chunkMax[c] = imax;
+        chunkPositive[c] = positive;
+      });
+      uint64_t quantised = 0;
+      std::size_t imax = 0;
+      for (std::size_t c = 0; c < chunks; c++) {
+        quantised += chunkQ[c];
+        if (weights[chunkMax[c]] > weights[imax]) imax = chunkMax[c];
+      }
+
+      // Truncation leaves a residue of less than one unit per item. Hand it out a unit at a
+      // time to the leading items of non-zero weight; anything beyond that is floating point
+      // error of a few units, which the largest item absorbs.
+      if (quantised < target) {
+        uint64_t residue = target - quantised;
+        std::vector<std::size_t> chunkExtra(chunks);
+        for (std::size_t c = 0; c < chunks; c++) {
+          chunkExtra[c] = static_cast<std::size_t>(std::min(residue, static_cast<uint64_t>(chunkPositive[c])));
+          residue -= chunkExtra[c];
+        }
+        detail::parallelFor(chunks, threads, [&](const std::size_t c) {
+          for (std::size_t i = chunkBegin(c), extra = chunkExtra[c]; extra > 0; i++) {
+            if (weights[i] > 0.0) {
+              q[i]++;
+              extra--;
+            }
+          }
+        });
+        q[imax] += residue;
+      } else {
+        q[imax] -= quantised - target;
+      }
+
+      // classify: lights are short of a full column, heavies have surplus to give away
+      std::vector<std::size_t> chunkLights(chunks), chunkHeavies(chunks);
+      std::vector<uint64_t> chunkDeficit(chunks), chunkSurplus(chunks);
+      detail::parallelFor(chunks, threads, [&](const std::size_t c) {
+        std::size_t lights = 0, heavies = 0;
+        uint64_t deficit = 0, surplus = 0;
+        for (std::size_t i = chunkBegin(c); i < chunkBegin(c + 1); i++) {
+          if (q[i] < kColumn) {
+            lights++;
+            deficit += kColumn - q[i];
+          } else if (q[i] > kColumn) {
+            heavies++;
+            surplus += q[i] - kColumn;
+          }
+        }
+        chunkLights[c] = lights;
+        chunkHeavies[c] = heavies;
+        chunkDeficit[c] = deficit;
+        chunkSurplus[c] = surplus;
+      });
+      std::size_t lights = 0, heavies = 0;
+      uint64_t deficit = 0, surplus = 0;
+      for (std::size_t c = 0; c < chunks; c++) {
+        std::size_t l = chunkLights[c], h = chunkHeavies[c];
+        uint64_t d = chunkDeficit[c], s = chunkSurplus[c];
+        chunkLights[c] = lights;
+        chunkHeavies[c] = heavies;
+        chunkDeficit[c] = deficit;
+        chunkSurplus[c] = surplus;
+        lights += l;
+        heavies += h;
+        deficit += d;
+        surplus += s;
+      }
+
+      // lightIdx/heavyIdx list the items in index order; lightSum/heavySum are inclusive prefix
+      // sums of their deficits and surpluses
+      std::vector<uint32_t> lightIdx(lights), heavyIdx(heavies);
+      std::vector<uint64_t> lightSum(lights), heavySum(heavies);
+      table.resize(n);
+      detail::parallelFor(chunks, threads, [&](const std::size_t c) {
+        std::size_t l = chunkLights[c], h = chunkHeavies[c];
+        uint64_t d = chunkDeficit[c], s = chunkSurplus[c];
+        for (std::size_t i = chunkBegin(c); i < chunkBegin(c + 1); i++) {
+          if (q[i] < kColumn) {
+            d += kColumn - q[i];
+            lightIdx[l] = static_cast<uint32_t>(i);
+            lightSum[l++] = d;
+          } else if (q[i] > kColumn) {
+            s += q[i] - kColumn;
+            heavyIdx[h] = static_cast<uint32_t>(i);
+            heavySum[h++] = s;
+          } else {
+            table[i].threshold = UINT32_MAX;
+            table[i].alias = static_cast<uint32_t>(i);
+          }
+        }
+      });
+
+      // Sweep pairing (Huebschle-Schneider & Sanders). Laying the deficits of the lights end to
+      // end against the surpluses of the heavies, light t takes its alias from the first heavy
+      // whose cumulative surplus passes the light's starting offset, and heavy k keeps whatever
+      // is left of its own column once the lights it has absorbed overrun its cumulative
+      // surplus, filling the rest from heavy k + 1. Each is a merge of two sorted sequences, so
+      // both halves split into independent chunks.
+      const std::size_t lightChunks = (lights + kAliasBuildChunk - 1) / kAliasBuildChunk;
+      detail::parallelFor(lightChunks, threads, [&](const std::size_t c) {
+        const std::size_t first = c * kAliasBuildChunk, last = std::min(lights, first + kAliasBuildChunk);
+        const uint64_t start = lightSum[first] - (kColumn - q[lightIdx[first]]);
+        std::size_t k = static_cast<std::size_t>(std::upper_bound(heavySum.begin(), heavySum.end(), start) - heavySum.begin());
+        for (std::size_t t = first; t < last; t++) {
+          const uint32_t i = lightIdx[t];
+          const uint64_t offset = lightSum[t] - (kColumn - q[i]);
+          while (heavySum[k] <= offset) k++;
+          table[i].threshold = static_cast<uint32_t>(q[i]);
+          table[i].alias = heavyIdx[k];
+        }
+      });
+      const std::size_t heavyChunks = (heavies + kAliasBuildChunk - 1) / kAliasBuildChunk;
+      detail::parallelFor(heavyChunks, threads, [&](const std::size_t c) {
+        const std::size_t first = c * kAliasBuildChunk, last = std::min(heavies, first + kAliasBuildChunk);
+        std::size_t t = static_cast<std::size_t>(std::lower_bound(lightSum.begin(), lightSum.end(), heavySum[first]) - lightSum.begin());
+        for (std::size_t k = first; k < last; k++) {
+          const uint32_t i = heavyIdx[k];
+          while (lightSum[t] < heavySum[k]) t++;
+          const uint64_t keep = kColumn + heavySum[k] - lightSum[t];
+          if (keep >= kColumn || k + 1 == heavies) {
+            table[i].threshold = UINT32_MAX;
+            table[i].alias = i;
+          } else {
+            table[i].threshold = static_cast<uint32_t>(keep);
+            table[i].alias = heavyIdx[k + 1];
+          }
+        }
+      });
+
+      singleWord = n <= kAliasSingleWordMaxSize;
+    }
+
+    void build(const std::vector<double>& weights, const unsigned threads = 1) { build(weights.data(), weights.size(), threads); }
+
+    std::size_t size() const { return table.size(); }
+
+    // draw one index
+    template <class Engine>
+    result_type operator()(Engine& eng) const {
+      result_type out;
+      sample(eng, &out, 1);
+      return out;
+    }
+
+    // Fill out with count independent draws. Words are taken from eng a run at a time, the
+    // columns for a whole run are computed and prefetched, and only then are the table entries
+    // read. No more words are taken than the draws use, so sampling count values in one call
+    // leaves eng in the same state as count calls to operator(). Throws std::logic_error if the
+    // table has not been built.
+    template <class Engine>
+    void sample(Engine& eng, result_type* out, std::size_t count) const {
+      if (table.empty()) throw std::logic_error("AliasTable: drawing from a table that has not been built");
+      const uint32_t n = static_cast<uint32_t>(table.size());
+      const std::size_t perDraw = singleWord ? 1 : 2;
+      uint32_t words[kRandSize];
+      uint32_t frac[kRandSize];
+      std::size_t have = 0, pos = 0, pending = count * perDraw;
+      auto next = [&]() {
+        if (pos == have) {
+          have = std::min(std::max(pending, std::size_t(1)), kRandSize);
+          eng.generate(words, have);
+          pos = 0;
+        }
+        if (pending > 0) pending--;
+        return words[pos++];
+      };
+
+      while (count > 0) {
+        const std::size_t batch = std::min(count, kRandSize / perDraw);
+        if (singleWord) {
+          // column from the high half of the product, threshold fraction from the low half
+          for (std::size_t i = 0; i < batch; i++) {
+            const uint64_t m = static_cast<uint64_t>(next()) * n;
+            out[i] = static_cast<uint32_t>(m >> 32);
+            frac[i] = static_cast<uint32_t>(m);
+            detail::prefetch(&table[out[i]]);
+          }
+        } else {
+          for (std::size_t i = 0; i < batch; i++) {
+            out[i] = detail::bounded32(n, next);
+            frac[i] = next();
+            detail::prefetch(&table[out[i]]);
+          }
+        }
+
+        for (std::size_t i = 0; i < batch; i++) {
+          const Column& col = table[out[i]];
+          if (frac[i] >= col.threshold) out[i] = col.alias;
+        }
+
+        out += batch;
+        count -= batch;
+      }
+    }
+
+   private:
+    static const uint64_t kColumn = uint64_t(1) << 32;
+
+    // Neumaier summation step
+    static void compensatedAdd(double& sum, double& err, const double x) {
+      double t = sum + x;
+      err += std::fabs(sum) >= std::fabs(x) ? (sum - t) + x : (x - t) + sum;
+      sum = t;
+    }
+
+    struct Column {
+      uint32_t threshold;  // keep the column's own index when the fraction is below this
+      uint32_t alias;
+    };
+
+    std::vector<Column> table;
+    bool singleWord;
+  };
+}  // namespace IsaacRNG
+
+#endif
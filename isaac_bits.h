@@ -0,0 +1,208 @@
+#ifndef __ISAAC_BITS_H__
+#define __ISAAC_BITS_H__
+
+/**********************************************************************************
+
+  Bit-level draws from ISAAC output. BitPool hands out coin flips and small
+  k-bit values from a 64-bit shift register refilled from whole output
+  blocks, so a coin flip costs one bit of generator output rather than a
+  word. It also fills bit masks with Bernoulli(p) bits, using geometric skips
+  between set bits when p is small.
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+  --
+
+  N.B. a C++ compiler capable of generating C++14 compliant
+  code is REQUIRED. g++ 5 will work, although g++ 6.1 or higher
+  is preferred.
+
+**********************************************************************************/
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "isaac.h"
+
+namespace IsaacRNG {
+  // fillBernoulli switches from word-parallel generation to geometric skips below this density
+  const double kBernoulliSkipThreshold = 1.0 / 16.0;
+  // word-parallel Bernoulli bits use p rounded to this many binary places
+  const unsigned kBernoulliPrecisionBits = 32;
+  // BitPool::below draws 16 bits per attempt for ranges up to this size
+  const uint32_t kBitPoolSmallRange = 256;
+
+  // Engine is Isaac or IsaacEngine. The pool draws from it a block at a time; bits still
+  // buffered when the pool is destroyed are discarded.
+  template <class Engine = Isaac>
+  class BitPool {
+   public:
+    using result_type = uint32_t;
+    static constexpr result_type(min)() { return 0; }
+    static constexpr result_type(max)() { return UINT32_MAX; }
+
+    explicit BitPool(Engine& engine) : eng(engine), reg(0), avail(0), pos(kRandSize) {}
+    BitPool(const BitPool&) = delete;
+    BitPool& operator=(const BitPool&) = delete;
+
+    // a full 32-bit word, so that the pool can also feed the standard distributions
+    result_type operator()() { return nextBits(32); }
+
+    bool bernoulliHalf() {
+      if (avail == 0) reload();
+      bool bit = reg & 1;
+      reg >>= 1;
+      avail--;
+      return bit;
+    }
+
+    // the next k bits, 1 <= k <= 32, as an integer uniform on [0, 2^k)
+    uint32_t nextBits(const unsigned k) { return take(k, reg, avail); }
+
+    // Uniform on [0, n) for n >= 1, by Lemire's multiply-and-reject. Ranges up to 256 (dice, small
+    // enums) draw 16 bits at a time and retry with probability below n / 65536; larger ranges draw
+    // full words.
+    uint32_t below(const uint32_t n) { return n <= 1 ? 0 : bounded(n, reg, avail); }
+
+    // Batch forms of the above. They yield exactly what count single calls would, but keep the
+    // shift register out of memory while they run.
+    void nextBits(const unsigned k, uint32_t* const out, const std::size_t count) {
+      uint64_t r = reg;
+      unsigned a = avail;
+      for (std::size_t i = 0; i < count; i++) out[i] = take(k, r, a);
+      reg = r;
+      avail = a;
+    }
+
+    void below(const uint32_t n, uint32_t* const out, const std::size_t count) {
+      if (n <= 1) {
+        std::fill(out, out + count, uint32_t(0));
+        return;
+      }
+      uint64_t r = reg;
+      unsigned a = avail;
+      for (std::size_t i = 0; i < count; i++) out[i] = bounded(n, r, a);
+      reg = r;
+      avail = a;
+    }
+
+    // Set each of the first nbits bits of words (least significant bit first) independently
+    // with probability p, and clear the rest of the last word. Small p uses geometric skips,
+    // so the cost is proportional to the number of bits set; otherwise each 64-bit word takes
+    // one random word per significant binary place of p, up to kBernoulliPrecisionBits.
+    void fillBernoulli(uint64_t* const words, const std::size_t nbits, double p) {
+      const std::size_t nwords = (nbits + 63) / 64;
+      bool invert = false;
+      if (p > 0.5) {
+        p = 1.0 - p;
+        invert = true;
+      }
+
+      if (!(p > 0.0)) {
+        std::fill(words, words + nwords, uint64_t(0));
+      } else if (p < kBernoulliSkipThreshold) {
+        std::fill(words, words + nwords, uint64_t(0));
+        const double scale = 1.0 / std::log1p(-p);
+        for (std::size_t bit = skip(scale); bit < nbits; bit += 1 + skip(scale)) words[bit / 64] |= uint64_t(1) << (bit % 64);
+      } else {
+        // Walking the binary expansion of p from its least significant place upwards, each place
+        // ORs (for a 1) or ANDs (for a 0) in a fresh random word; every result bit then has
+        // exactly the quantised probability.
+        const uint64_t scaled = static_cast<uint64_t>(std::ldexp(p, kBernoulliPrecisionBits) + 0.5);
+        unsigned lowest = 0;
+        while (lowest < kBernoulliPrecisionBits && ((scaled >> lowest) & 1) == 0) lowest++;
+        for (std::size_t w = 0; w < nwords; w++) {
+          uint64_t acc = 0;
+          for (unsigned place = lowest; place < kBernoulliPrecisionBits; place++) {
+            acc = (scaled >> place) & 1 ? acc | next64() : acc & next64();
+          }
+          words[w] = acc;
+        }
+      }
+
+      if (invert) {
+        for (std::size_t w = 0; w < nwords; w++) words[w] = ~words[w];
+      }
+      if (nbits % 64 != 0) words[nwords - 1] &= lowMask(static_cast<unsigned>(nbits % 64));
+    }
+
+    template <std::size_t N>
+    void fillBernoulli(std::bitset<N>& bits, const double p) {
+      std::vector<uint64_t> words((N + 63) / 64);
+      fillBernoulli(words.data(), N, p);
+      for (std::size_t i = 0; i < N; i++) bits[i] = (words[i / 64] >> (i % 64)) & 1;
+    }
+
+   private:
+    static uint64_t lowMask(const unsigned k) { return k >= 64 ? ~uint64_t(0) : (uint64_t(1) << k) - 1; }
+    static uint32_t wordMask(const unsigned k) { return static_cast<uint32_t>((uint64_t(1) << k) - 1); }
+
+    uint32_t next32() {
+      if (pos == kRandSize) {
+        eng.generate(buf, kRandSize);
+        pos = 0;
+      }
+      return buf[pos++];
+    }
+
+    uint64_t next64() {
+      uint64_t lo = next32();
+      return lo | static_cast<uint64_t>(next32()) << 32;
+    }
+
+    // k bits from the register r holding a bits; r and a are either the members themselves or
+    // local copies of them
+    uint32_t take(const unsigned k, uint64_t& r, unsigned& a) {
+      if (a < k) {
+        // the bits left form the low end of the value, the rest comes from a fresh register
+        const unsigned have = a;
+        uint32_t value = static_cast<uint32_t>(r);
+        const uint64_t fresh = next64();
+        const unsigned need = k - have;
+        value |= (static_cast<uint32_t>(fresh) & wordMask(need)) << have;
+        r = fresh >> need;
+        a = 64 - need;
+        return value;
+      }
+      uint32_t value = static_cast<uint32_t>(r) & wordMask(k);
+      r >>= k;
+      a -= k;
+      return value;
+    }
+
+    uint32_t bounded(const uint32_t n, uint64_t& r, unsigned& a) {
+      const unsigned width = n <= kBitPoolSmallRange ? 16 : 32;
+      uint64_t m = static_cast<uint64_t>(take(width, r, a)) * n;
+      if ((m & lowMask(width)) < n) {
+        const uint64_t threshold = ((uint64_t(1) << width) - n) % n;
+        while ((m & lowMask(width)) < threshold) m = static_cast<uint64_t>(take(width, r, a)) * n;
+      }
+      return static_cast<uint32_t>(m >> width);
+    }
+
+    void reload() {
+      reg = next64();
+      avail = 64;
+    }
+
+    // number of failures before the next success of a Bernoulli trial, scale = 1 / log(1 - p)
+    std::size_t skip(const double scale) {
+      const double u = std::ldexp(static_cast<double>((next64() >> 11) + 1), -53);
+      const double gap = std::floor(std::log(u) * scale);
+      return gap < 1e18 ? static_cast<std::size_t>(gap) : static_cast<std::size_t>(-1) / 2;
+    }
+
+    Engine& eng;
+    uint64_t reg;
+    unsigned avail;
+    std::size_t pos;
+    uint32_t buf[kRandSize];
+  };
+}  // namespace IsaacRNG
+
+#endif
@@ -0,0 +1,263 @@
+#ifndef __ISAAC_BULK_SEED_H__
+#define __ISAAC_BULK_SEED_H__
+
+/**********************************************************************************
+
+  Reseeding many Isaac engines at once.
+
+  Most of the cost of Isaac::seed() is randinit(). It makes two passes over
+  the 256-word state, each a serial chain of mix() rounds, and then generates
+  a first block. The chains of different engines are independent, so
+  bulkSeed() runs one engine's chain in each SIMD lane: four engines at a
+  time with SSE2, eight with AVX2. The four opening mix() rounds do not
+  depend on the seed and are computed once. The first block is generated for
+  a whole group of engines together, interleaving their steps so that their
+  dependency chains overlap. It stays scalar, because each step reads the
+  state at a data-dependent index. For the same reason it cannot start until
+  the second pass has finished, so the two are not fused.
+
+  Each engine ends up in exactly the state that seed() with the same key
+  gives. The seed expansion cache is not consulted.
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+  --
+
+  N.B. a C++ compiler capable of generating C++14 compliant
+  code is REQUIRED. g++ 5 will work, although g++ 6.1 or higher
+  is preferred.
+
+**********************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "isaac.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace IsaacRNG {
+  namespace detail {
+    // one word of randinit()'s state for each of a group of engines
+#if defined(__AVX2__)
+    const std::size_t kBulkSeedLanes = 8;
+    struct SeedLanes {
+      __m256i v;
+      static SeedLanes load(const uint32_t* p) { return {_mm256_load_si256(reinterpret_cast<const __m256i*>(p))}; }
+      static SeedLanes broadcast(const uint32_t x) { return {_mm256_set1_epi32(static_cast<int>(x))}; }
+      void store(uint32_t* p) const { _mm256_store_si256(reinterpret_cast<__m256i*>(p), v); }
+      SeedLanes operator+(const SeedLanes o) const { return {_mm256_add_epi32(v, o.v)}; }
+      SeedLanes operator^(const SeedLanes o) const { return {_mm256_xor_si256(v, o.v)}; }
+      template <int N>
+      SeedLanes shl() const {
+        return {_mm256_slli_epi32(v, N)};
+      }
+      template <int N>
+      SeedLanes shr() const {
+        return {_mm256_srli_epi32(v, N)};
+      }
+    };
+#elif defined(__SSE2__)
+    const std::size_t kBulkSeedLanes = 4;
+    struct SeedLanes {
+      __m128i v;
+      static SeedLanes load(const uint32_t* p) { return {_mm_load_si128(reinterpret_cast<const __m128i*>(p))}; }
+      static SeedLanes broadcast(const uint32_t x) { return {_mm_set1_epi32(static_cast<int>(x))}; }
+      void store(uint32_t* p) const { _mm_store_si128(reinterpret_cast<__m128i*>(p), v); }
+      SeedLanes operator+(const SeedLanes o) const { return {_mm_add_epi32(v, o.v)}; }
+      SeedLanes operator^(const SeedLanes o) const { return {_mm_xor_si128(v, o.v)}; }
+      template <int N>
+      SeedLanes shl() const {
+        return {_mm_slli_epi32(v, N)};
+      }
+      template <int N>
+      SeedLanes shr() const {
+        return {_mm_srli_epi32(v, N)};
+      }
+    };
+#else
+    const std::size_t kBulkSeedLanes = 1;
+    struct SeedLanes {
+      uint32_t v;
+      static SeedLanes load(const uint32_t* p) { return {*p}; }
+      static SeedLanes broadcast(const uint32_t x) { return {x}; }
+      void store(uint32_t* p) const { *p = v; }
+      SeedLanes operator+(const SeedLanes o) const { return {v + o.v}; }
+      SeedLanes operator^(const SeedLanes o) const { return {v ^ o.v}; }
+      template <int N>
+      SeedLanes shl() const {
+        return {v << N};
+      }
+      template <int N>
+      SeedLanes shr() const {
+        return {v >> N};
+      }
+    };
+#endif
+
+    // Isaac::mix on every lane
+    inline void mixLanes(SeedLanes& a, SeedLanes& b, SeedLanes& c, SeedLanes& d, SeedLanes& e, SeedLanes& f, SeedLanes& g,
+                         SeedLanes& h) {
+      a = a ^ b.shl<11>();
+      d = d + a;
+      b = b + c;
+      b = b ^ c.shr<2>();
+      e = e + b;
+      c = c + d;
+      c = c ^ d.shl<8>();
+      f = f + c;
+      d = d + e;
+      d = d ^ e.shr<16>();
+      g = g + d;
+      e = e + f;
+      e = e ^ f.shl<10>();
+      h = h + e;
+      f = f + g;
+      f = f ^ g.shr<4>();
+      a = a + f;
+      g = g + h;
+      g = g ^ h.shl<8>();
+      b = b + g;
+      h = h + a;
+      h = h ^ a.shr<9>();
+      c = c + h;
+      a = a + b;
+    }
+  }  // namespace detail
+
+  class IsaacBulkSeeder {
+   public:
+    // see bulkSeed()
+    template <class EngineIt, class KeyIt>
+    static void seed(EngineIt first, EngineIt last, KeyIt keys) {
+      Isaac* group[detail::kBulkSeedLanes];
+      alignas(32) uint32_t lanes[kRandSize * detail::kBulkSeedLanes];
+      while (first != last) {
+        std::size_t count = 0;
+        for (; count < detail::kBulkSeedLanes && first != last; ++first, ++keys, ++count) {
+          Isaac& isa = *first;
+          load(isa, *keys);
+          group[count] = &isa;
+        }
+        expand(group, count, lanes);
+      }
+    }
+
+   private:
+    static const std::size_t kLanes = detail::kBulkSeedLanes;
+
+    static void load(Isaac& isa, const std::string& key) { isa.loadKey(key.data(), Isaac::keyBytes(key.data(), key.size())); }
+    static void load(Isaac& isa, const std::vector<uint32_t>& key) { isa.loadKey(key.data(), key.size()); }
+
+    // a to h after randinit()'s four opening mix() rounds, which are the same for every seed
+    struct MixStart {
+      uint32_t v[8];
+      MixStart() {
+        std::fill(v, v + 8, GOLDEN_RATIO);
+        for (int i = 0; i < 4; i++) Isaac::mix(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]);
+      }
+    };
+
+    // randinit(true) for up to kLanes engines whose keys are loaded. Word i of engine l lives
+    // at lanes[i * kLanes + l] while the passes run.
+    static void expand(Isaac* const* group, const std::size_t count, uint32_t* lanes) {
+      static const MixStart start;
+
+      if (count < kLanes) std::fill(lanes, lanes + kRandSize * kLanes, 0);
+      for (std::size_t l = 0; l < count; l++) {
+        const uint32_t* r = group[l]->randrsl;
+        for (std::size_t i = 0; i < kRandSize; i++) lanes[i * kLanes + l] = r[i];
+      }
+
+      using detail::SeedLanes;
+      SeedLanes a = SeedLanes::broadcast(start.v[0]), b = SeedLanes::broadcast(start.v[1]), c = SeedLanes::broadcast(start.v[2]),
+                d = SeedLanes::broadcast(start.v[3]), e = SeedLanes::broadcast(start.v[4]), f = SeedLanes::broadcast(start.v[5]),
+                g = SeedLanes::broadcast(start.v[6]), h = SeedLanes::broadcast(start.v[7]);
+      // the first pass adds in the key and the second the first pass's output, both of which
+      // are in lanes already
+      for (int pass = 0; pass < 2; pass++) {
+        for (std::size_t i = 0; i < kRandSize; i += 8) {
+          uint32_t* p = lanes + i * kLanes;
+          a = a + SeedLanes::load(p);
+          b = b + SeedLanes::load(p + kLanes);
+          c = c + SeedLanes::load(p + 2 * kLanes);
+          d = d + SeedLanes::load(p + 3 * kLanes);
+          e = e + SeedLanes::load(p + 4 * kLanes);
+          f = f + SeedLanes::load(p + 5 * kLanes);
+          g = g + SeedLanes::load(p + 6 * kLanes);
+          h = h + SeedLanes::load(p + 7 * kLanes);
+          detail::mixLanes(a, b, c, d, e, f, g, h);
+          a.store(p);
+          b.store(p + kLanes);
+          c.store(p + 2 * kLanes);
+          d.store(p + 3 * kLanes);
+          e.store(p + 4 * kLanes);
+          f.store(p + 5 * kLanes);
+          g.store(p + 6 * kLanes);
+          h.store(p + 7 * kLanes);
+        }
+      }
+
+      for (std::size_t l = 0; l < count; l++) {
+        uint32_t* m = group[l]->randmem;
+        for (std::size_t i = 0; i < kRandSize; i++) m[i] = lanes[i * kLanes + l];
+      }
+      firstBlock(group, count);
+    }
+
+    // Isaac::isaac() from the freshly expanded state of every engine in the group, step by step
+    // across the group, so that the engines' serial chains overlap
+    static void firstBlock(Isaac* const* group, const std::size_t count) {
+      uint32_t a[kLanes], b[kLanes];
+      for (std::size_t l = 0; l < count; l++) {
+        a[l] = 0;
+        b[l] = 1;  // randb plus the incremented randc
+      }
+      for (std::size_t i = 0; i < kRandSize; i += 4) {
+        for (std::size_t l = 0; l < count; l++) {
+          uint32_t* const mm = group[l]->randmem;
+          uint32_t* const r = group[l]->randrsl;
+          step(a[l] << 13, a[l], b[l], mm, r, i);
+          step(a[l] >> 6, a[l], b[l], mm, r, i + 1);
+          step(a[l] << 2, a[l], b[l], mm, r, i + 2);
+          step(a[l] >> 16, a[l], b[l], mm, r, i + 3);
+        }
+      }
+      for (std::size_t l = 0; l < count; l++) {
+        Isaac& isa = *group[l];
+        isa.randa = a[l];
+        isa.randb = b[l];
+        isa.randc = 1;
+        isa.randcnt = kRandSize;
+        isa.pending = false;
+      }
+    }
+
+    // Isaac::rngstep for word i, whose partner is half the state away
+    static void step(const uint32_t mixit, uint32_t& a, uint32_t& b, uint32_t* const mm, uint32_t* const r, const std::size_t i) {
+      const uint32_t x = mm[i];
+      a = (a ^ mixit) + mm[(i + kRandSize / 2) % kRandSize];
+      const uint32_t y = Isaac::ind(mm, x) + a + b;
+      mm[i] = y;
+      r[i] = b = Isaac::ind(mm, y >> kRandSizeBits) + x;
+    }
+  };
+
+  // Seed each Isaac in [first, last) from the key at the same position in the range starting at
+  // keys, exactly as isa.seed(key.data(), key.size()) would. Keys are std::string or
+  // std::vector<uint32_t>.
+  template <class EngineIt, class KeyIt>
+  void bulkSeed(EngineIt first, EngineIt last, KeyIt keys) {
+    IsaacBulkSeeder::seed(first, last, keys);
+  }
+}  // namespace IsaacRNG
+
+#endif
@@ -47,6 +47,15 @@ namespace IsaacRNG {
     IsaacEngine(std::random_device &rd) : prng(rd) {}
     IsaacEngine(const std::vector<uint32_t> &seedVec) : prng(seedVec.data(), seedVec.size()) {}
     IsaacEngine(const std::string &seedStr) : prng(seedStr.data(), seedStr.length()) {}
+    template <class Sseq, class = detail::EnableIfSeedSeq<Sseq, IsaacEngine>>
+    explicit IsaacEngine(Sseq &q) : prng(q) {}
+    // lazily seeded forms; see LazySeed in isaac.h
+    explicit IsaacEngine(LazySeed) : prng(kLazySeed) {}
+    IsaacEngine(LazySeed, std::random_device &rd) : prng(kLazySeed, rd) {}
+    IsaacEngine(LazySeed, const std::vector<uint32_t> &seedVec) : prng(kLazySeed, seedVec.data(), seedVec.size()) {}
+    IsaacEngine(LazySeed, const std::string &seedStr) : prng(kLazySeed, seedStr.data(), seedStr.length()) {}
+    template <class Sseq, class = detail::EnableIfSeedSeq<Sseq, IsaacEngine>>
+    IsaacEngine(LazySeed, Sseq &q) : prng(kLazySeed, q) {}
     IsaacEngine(const IsaacEngine &iseng) : prng(iseng.prng) {}
     IsaacEngine(IsaacEngine &&iseng) noexcept : prng(std::move(iseng.prng)) {}
 
@@ -65,12 +74,23 @@ namespace IsaacRNG {
     void seed(std::random_device &rd) { prng.seed(rd); }
     void seed(const std::vector<uint32_t> &seedVec) { prng.seed(seedVec.data(), seedVec.size()); }
     void seed(const std::string &seedStr) { prng.seed(seedStr.data(), seedStr.length()); }
+    template <class Sseq, class = detail::EnableIfSeedSeq<Sseq, IsaacEngine>>
+    void seed(Sseq &q) { prng.seed(q); }
+    void seed(LazySeed) { prng.seed(kLazySeed); }
+    void seed(LazySeed, std::random_device &rd) { prng.seed(kLazySeed, rd); }
+    void seed(LazySeed, const std::vector<uint32_t> &seedVec) { prng.seed(kLazySeed, seedVec.data(), seedVec.size()); }
+    void seed(LazySeed, const std::string &seedStr) { prng.seed(kLazySeed, seedStr.data(), seedStr.length()); }
+    template <class Sseq, class = detail::EnableIfSeedSeq<Sseq, IsaacEngine>>
+    void seed(LazySeed, Sseq &q) { prng.seed(kLazySeed, q); }
     void seed(const IsaacEngine &iseng) {
       if (this != &iseng) prng.seed(iseng.prng);
     }
 
     result_type operator()() { return prng.rand(); }
 
+    // bulk equivalent of n calls to operator()
+    void generate(result_type *dest, std::size_t n) { prng.generate(dest, n); }
+
     bool operator==(const IsaacEngine &rhs) { return prng == rhs.prng; }
 
     bool operator!=(const IsaacEngine &rhs) { return !(prng == rhs.prng); }
@@ -0,0 +1,248 @@
+#ifndef __ISAAC_IDS_H__
+#define __ISAAC_IDS_H__
+
+/**********************************************************************************
+
+  Batched generation of UUIDv4s, nonces and hex or base64url tokens.
+
+  IdGenerator takes the random bytes for each identifier from whole ISAAC
+  output blocks and writes the results straight into buffers supplied by the
+  caller, so a batch costs no allocation. Hex output is encoded sixteen bytes
+  at a time with SSE2 and base64url twelve bytes at a time with SSSE3 where
+  the compiler targets them; other targets use table-driven scalar code that
+  gives identical output.
+
+  Bytes are taken from the output words in host byte order.
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+  --
+
+  N.B. a C++ compiler capable of generating C++14 compliant
+  code is REQUIRED. g++ 5 will work, although g++ 6.1 or higher
+  is preferred.
+
+**********************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "isaac.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+namespace IsaacRNG {
+  const std::size_t kUuidBytes = 16;
+  const std::size_t kUuidStringLength = 36;  // 8-4-4-4-12 lower case hex digits, no terminator
+  const std::size_t kMaxIdBytes = 256;       // longest nonce or token, in random bytes
+
+  namespace detail {
+    const char kHexDigits[] = "0123456789abcdef";
+    const char kBase64UrlDigits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+    // n bytes to 2n lower case hex digits
+    inline void encodeHex(const uint8_t* in, std::size_t n, char* out) {
+#if defined(__SSE2__)
+      const __m128i lowNibbles = _mm_set1_epi8(0x0f);
+      const __m128i nine = _mm_set1_epi8(9);
+      const __m128i zero = _mm_set1_epi8('0');
+      const __m128i letterGap = _mm_set1_epi8('a' - '0' - 10);
+      auto digits = [&](__m128i v) {
+        return _mm_add_epi8(_mm_add_epi8(v, zero), _mm_and_si128(_mm_cmpgt_epi8(v, nine), letterGap));
+      };
+      for (; n >= 16; n -= 16, in += 16, out += 32) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), lowNibbles);
+        const __m128i lo = _mm_and_si128(v, lowNibbles);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), digits(_mm_unpacklo_epi8(hi, lo)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), digits(_mm_unpackhi_epi8(hi, lo)));
+      }
+#endif
+      for (; n > 0; n--, in++) {
+        *out++ = kHexDigits[*in >> 4];
+        *out++ = kHexDigits[*in & 0x0f];
+      }
+    }
+
+    // 16 random bytes to the text of a version 4 UUID. The version and variant are patched into
+    // the digits rather than the bytes, as byte stores would stall the vector load.
+    inline void formatUuid(const uint8_t* id, char* out) {
+#if defined(__SSE2__)
+      const __m128i lowNibbles = _mm_set1_epi8(0x0f);
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(id));
+      const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), lowNibbles);
+      const __m128i lo = _mm_and_si128(v, lowNibbles);
+      auto digits = [](__m128i x) {
+        return _mm_add_epi8(_mm_add_epi8(x, _mm_set1_epi8('0')),
+                            _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10)));
+      };
+      const __m128i first = digits(_mm_unpacklo_epi8(hi, lo));   // digits 0 to 15
+      const __m128i second = digits(_mm_unpackhi_epi8(hi, lo));  // digits 16 to 31
+      // overlapping stores put each run of digits in place, then the dashes go in
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 20), second);
+      const uint32_t run16 = static_cast<uint32_t>(_mm_cvtsi128_si32(second));
+      std::memcpy(out + 19, &run16, 4);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), first);
+      // digits 8 to 15 go through memory, as a 64-bit move out of a vector needs x86-64
+      char run8[8];
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(run8), _mm_srli_si128(first, 8));
+      std::memcpy(out + 9, run8, 4);
+      std::memcpy(out + 14, run8 + 4, 4);
+#else
+      char hex[2 * kUuidBytes];
+      encodeHex(id, kUuidBytes, hex);
+      std::memcpy(out, hex, 8);
+      std::memcpy(out + 9, hex + 8, 4);
+      std::memcpy(out + 14, hex + 12, 4);
+      std::memcpy(out + 19, hex + 16, 4);
+      std::memcpy(out + 24, hex + 20, 12);
+#endif
+      out[8] = out[13] = out[18] = out[23] = '-';
+      out[14] = '4';
+      out[19] = kHexDigits[8 | ((id[8] >> 4) & 3)];
+    }
+
+    // the eight 6-bit fields of six bytes, one per byte, first field lowest
+    inline uint64_t base64Fields(const uint8_t* in) {
+      const uint64_t hi = static_cast<uint64_t>(in[0]) << 16 | static_cast<uint64_t>(in[1]) << 8 | in[2];
+      const uint64_t lo = static_cast<uint64_t>(in[3]) << 16 | static_cast<uint64_t>(in[4]) << 8 | in[5];
+      return (hi >> 18) | ((hi >> 12) & 0x3f) << 8 | ((hi >> 6) & 0x3f) << 16 | (hi & 0x3f) << 24 | (lo >> 18) << 32 |
+             ((lo >> 12) & 0x3f) << 40 | ((lo >> 6) & 0x3f) << 48 | (lo & 0x3f) << 56;
+    }
+
+    // n bytes to base64url without padding. in must be readable for four bytes past the
+    // last multiple of twelve.
+    inline void encodeBase64Url(const uint8_t* in, std::size_t n, char* out) {
+#if defined(__SSSE3__)
+      // Muła and Lemire: spread 12 bytes over 16 lanes, cut out the 6-bit fields with two
+      // multiplies, then map each field to its digit with one table lookup.
+      const __m128i spread = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+      const __m128i shifts = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0);
+      for (; n >= 12; n -= 12, in += 12, out += 16) {
+        const __m128i v = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), spread);
+        const __m128i ac = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+        const __m128i bd = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+        const __m128i fields = _mm_or_si128(ac, bd);
+        __m128i classes = _mm_subs_epu8(fields, _mm_set1_epi8(51));
+        classes = _mm_or_si128(classes, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), fields), _mm_set1_epi8(13)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_add_epi8(fields, _mm_shuffle_epi8(shifts, classes)));
+      }
+#elif defined(__SSE2__)
+      // without a byte shuffle the 6-bit fields are cut out in scalar code, and only the
+      // mapping from field to digit is done sixteen lanes at a time
+      for (; n >= 12; n -= 12, in += 12, out += 16) {
+        const __m128i fields = _mm_set_epi64x(static_cast<long long>(base64Fields(in + 6)), static_cast<long long>(base64Fields(in)));
+        __m128i shift = _mm_set1_epi8('A');
+        shift = _mm_add_epi8(shift, _mm_and_si128(_mm_cmpgt_epi8(fields, _mm_set1_epi8(25)), _mm_set1_epi8('a' - 26 - 'A')));
+        shift = _mm_add_epi8(shift, _mm_and_si128(_mm_cmpgt_epi8(fields, _mm_set1_epi8(51)), _mm_set1_epi8('0' - 52 - ('a' - 26))));
+        shift = _mm_add_epi8(shift, _mm_and_si128(_mm_cmpgt_epi8(fields, _mm_set1_epi8(61)), _mm_set1_epi8('-' - 62 - ('0' - 52))));
+        shift = _mm_add_epi8(shift, _mm_and_si128(_mm_cmpgt_epi8(fields, _mm_set1_epi8(62)), _mm_set1_epi8('_' - 63 - ('-' - 62))));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_add_epi8(fields, shift));
+      }
+#endif
+      for (; n >= 3; n -= 3, in += 3) {
+        const uint32_t v = static_cast<uint32_t>(in[0]) << 16 | static_cast<uint32_t>(in[1]) << 8 | in[2];
+        *out++ = kBase64UrlDigits[v >> 18];
+        *out++ = kBase64UrlDigits[(v >> 12) & 0x3f];
+        *out++ = kBase64UrlDigits[(v >> 6) & 0x3f];
+        *out++ = kBase64UrlDigits[v & 0x3f];
+      }
+      if (n > 0) {
+        const uint32_t v = static_cast<uint32_t>(in[0]) << 16 | (n > 1 ? static_cast<uint32_t>(in[1]) << 8 : 0);
+        *out++ = kBase64UrlDigits[v >> 18];
+        *out++ = kBase64UrlDigits[(v >> 12) & 0x3f];
+        if (n > 1) *out++ = kBase64UrlDigits[(v >> 6) & 0x3f];
+      }
+    }
+  }  // namespace detail
+
+  // characters in the unpadded base64url encoding of bytes random bytes
+  constexpr std::size_t base64UrlLength(const std::size_t bytes) { return (bytes * 4 + 2) / 3; }
+
+  // Engine is Isaac or IsaacEngine. Every output buffer must have room for count identifiers
+  // of the stated size laid end to end; strings are not terminated. Bytes still buffered when
+  // the generator is destroyed are discarded.
+  template <class Engine = Isaac>
+  class IdGenerator {
+   public:
+    explicit IdGenerator(Engine& engine) : eng(engine), pos(0), fill(0) { std::memset(buf, 0, sizeof(buf)); }
+    IdGenerator(const IdGenerator&) = delete;
+    IdGenerator& operator=(const IdGenerator&) = delete;
+
+    // count binary UUIDs of kUuidBytes each, with the version 4 and RFC 4122 variant bits set
+    void uuid4(uint8_t* out, std::size_t count) {
+      for (; count > 0; count--, out += kUuidBytes) {
+        std::memcpy(out, take(kUuidBytes), kUuidBytes);
+        setUuidBits(out);
+      }
+    }
+
+    // count UUIDs in their canonical text form, kUuidStringLength characters each
+    void uuid4Strings(char* out, std::size_t count) {
+      for (; count > 0; count--, out += kUuidStringLength) detail::formatUuid(take(kUuidBytes), out);
+    }
+
+    // count raw nonces of bytes bytes each
+    void nonces(uint8_t* out, std::size_t count, const std::size_t bytes) {
+      checkLength(bytes);
+      for (; count > 0; count--, out += bytes) std::memcpy(out, take(bytes), bytes);
+    }
+
+    // count tokens of bytes random bytes each, as 2 * bytes hex digits
+    void hexTokens(char* out, std::size_t count, const std::size_t bytes) {
+      checkLength(bytes);
+      for (; count > 0; count--, out += 2 * bytes) detail::encodeHex(take(bytes), bytes, out);
+    }
+
+    // count tokens of bytes random bytes each, as base64UrlLength(bytes) characters
+    void base64UrlTokens(char* out, std::size_t count, const std::size_t bytes) {
+      checkLength(bytes);
+      for (; count > 0; count--, out += base64UrlLength(bytes)) detail::encodeBase64Url(take(bytes), bytes, out);
+    }
+
+   private:
+    static const std::size_t kBlockBytes = kRandSize * sizeof(uint32_t);
+
+    static void setUuidBits(uint8_t* id) {
+      id[6] = static_cast<uint8_t>((id[6] & 0x0f) | 0x40);
+      id[8] = static_cast<uint8_t>((id[8] & 0x3f) | 0x80);
+    }
+
+    static void checkLength(const std::size_t bytes) {
+      if (bytes == 0 || bytes > kMaxIdBytes) throw std::invalid_argument("IdGenerator: identifier length must be 1 to 256 bytes");
+    }
+
+    // n <= kMaxIdBytes contiguous random bytes, valid until the next call. Bytes left over at
+    // the end of a block move to the front, ahead of the next whole block.
+    const uint8_t* take(const std::size_t n) {
+      if (fill - pos < n) {
+        const std::size_t left = fill - pos;
+        std::memmove(buf, buf + pos, left);
+        uint32_t words[kRandSize];
+        eng.generate(words, kRandSize);
+        std::memcpy(buf + left, words, kBlockBytes);
+        pos = 0;
+        fill = left + kBlockBytes;
+      }
+      const uint8_t* p = buf + pos;
+      pos += n;
+      return p;
+    }
+
+    Engine& eng;
+    std::size_t pos, fill;
+    // room for a partial identifier, a block, and the over-read of the vector encoders
+    uint8_t buf[kMaxIdBytes + kBlockBytes + 16];
+  };
+}  // namespace IsaacRNG
+
+#endif
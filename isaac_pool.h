@@ -0,0 +1,230 @@
+#ifndef __ISAAC_POOL_H__
+#define __ISAAC_POOL_H__
+
+/**********************************************************************************
+
+  Pre-generated ISAAC output pools for replay runs.
+
+  IsaacPoolEngine::write() stores the first N values of a seeded Isaac stream
+  in a file, together with the seed and the complete generator state after
+  the last stored value. IsaacPoolEngine memory-maps such a file and serves
+  the stored values straight from the page cache; once they are used up it
+  carries on with live generation from the saved state, so the values it
+  yields are exactly those of the original stream throughout.
+
+  Pool files are written in host byte order. POSIX mmap is required.
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+  --
+
+  N.B. a C++ compiler capable of generating C++14 compliant
+  code is REQUIRED. g++ 5 will work, although g++ 6.1 or higher
+  is preferred.
+
+**********************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "isaac.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#error "isaac_pool.h requires POSIX mmap"
+#endif
+
+namespace IsaacRNG {
+  const uint32_t kPoolVersion = 1;
+  const std::size_t kPoolDataAlign = 4096;  // pool data starts on a page boundary
+
+  struct IsaacPoolHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t seedlen;
+    uint64_t words;
+    uint64_t dataOffset;
+    char seed[kRandSize * sizeof(uint32_t)];
+    // generator state after the last pooled value
+    uint32_t randmem[kRandSize];
+    uint32_t randrsl[kRandSize];
+    uint32_t randa, randb, randc, randcnt;
+  };
+
+  class IsaacPoolEngine {
+   public:
+    using result_type = uint32_t;
+    static constexpr result_type(min)() { return 0; }
+    static constexpr result_type(max)() { return UINT32_MAX; }
+
+    // Write the first words values of the stream seeded with seedArr to path. Seeds longer than
+    // 1024 bytes are truncated exactly as Isaac::seed() truncates them.
+    static void write(const std::string& path, const char* const seedArr, const std::size_t seedlen, const uint64_t words) {
+      IsaacPoolHeader header;
+      std::memset(&header, 0, sizeof(header));
+      std::memcpy(header.magic, kMagic, sizeof(header.magic));
+      header.version = kPoolVersion;
+      header.seedlen = static_cast<uint32_t>(seedArr != nullptr ? std::min(seedlen, sizeof(header.seed)) : 0);
+      if (header.seedlen > 0) std::memcpy(header.seed, seedArr, header.seedlen);
+      header.words = words;
+      header.dataOffset = (sizeof(header) + kPoolDataAlign - 1) / kPoolDataAlign * kPoolDataAlign;
+
+      std::ofstream out(path, std::ios::binary | std::ios::trunc);
+      if (!out) throw std::runtime_error("IsaacPoolEngine: cannot create " + path);
+      std::vector<char> pad(header.dataOffset, 0);
+      out.write(pad.data(), static_cast<std::streamsize>(pad.size()));
+
+      Isaac prng(header.seed, header.seedlen);
+      std::vector<uint32_t> buf(std::size_t(1) << 20);
+      for (uint64_t left = words; left > 0;) {
+        std::size_t take = static_cast<std::size_t>(std::min<uint64_t>(left, buf.size()));
+        prng.generate(buf.data(), take);
+        out.write(reinterpret_cast<const char*>(buf.data()), static_cast<std::streamsize>(take * sizeof(uint32_t)));
+        left -= take;
+      }
+
+      std::copy(prng.randmem, prng.randmem + kRandSize, header.randmem);
+      std::copy(prng.randrsl, prng.randrsl + kRandSize, header.randrsl);
+      header.randa = prng.randa;
+      header.randb = prng.randb;
+      header.randc = prng.randc;
+      header.randcnt = prng.randcnt;
+      out.seekp(0);
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      out.close();
+      if (!out) throw std::runtime_error("IsaacPoolEngine: I/O error writing " + path);
+    }
+
+    // Map the pool at path. With populate the whole pool is faulted in up front where the
+    // platform supports it; otherwise pages are read ahead as they are used.
+    explicit IsaacPoolEngine(const std::string& path, const bool populate = false)
+        : live(kLazySeed), endState(kLazySeed), mapping(nullptr), mapLength(0) {
+      int fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0) throw std::runtime_error("IsaacPoolEngine: cannot open " + path);
+      struct stat st;
+      if (::fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < sizeof(IsaacPoolHeader)) {
+        ::close(fd);
+        throw std::runtime_error("IsaacPoolEngine: " + path + " is not a pool file");
+      }
+
+      int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+      if (populate) flags |= MAP_POPULATE;
+#else
+      (void)populate;
+#endif
+      mapLength = static_cast<std::size_t>(st.st_size);
+      void* addr = ::mmap(nullptr, mapLength, PROT_READ, flags, fd, 0);
+      ::close(fd);
+      if (addr == MAP_FAILED) throw std::runtime_error("IsaacPoolEngine: cannot map " + path);
+      mapping = addr;
+
+      const IsaacPoolHeader& h = header();
+      if (std::memcmp(h.magic, kMagic, sizeof(h.magic)) != 0 || h.version != kPoolVersion || h.dataOffset % sizeof(uint32_t) != 0 ||
+          h.dataOffset > mapLength || h.words > (mapLength - h.dataOffset) / sizeof(uint32_t) || h.randcnt > kRandSize) {
+        unmap();
+        throw std::runtime_error("IsaacPoolEngine: " + path + " is not a valid pool file");
+      }
+      ::madvise(mapping, mapLength, MADV_SEQUENTIAL);
+
+      pool = reinterpret_cast<const uint32_t*>(static_cast<const char*>(mapping) + h.dataOffset);
+      std::copy(h.randmem, h.randmem + kRandSize, endState.randmem);
+      std::copy(h.randrsl, h.randrsl + kRandSize, endState.randrsl);
+      endState.randa = h.randa;
+      endState.randb = h.randb;
+      endState.randc = h.randc;
+      endState.randcnt = h.randcnt;
+      endState.pending = false;
+      seek(0);
+    }
+
+    IsaacPoolEngine(const IsaacPoolEngine&) = delete;
+    IsaacPoolEngine& operator=(const IsaacPoolEngine&) = delete;
+    ~IsaacPoolEngine() { unmap(); }
+
+    result_type operator()() {
+      if (cur == end) refill();
+      return *cur++;
+    }
+
+    void generate(result_type* dest, std::size_t n) {
+      while (n > 0) {
+        if (cur == end) refill();
+        std::size_t take = std::min(n, static_cast<std::size_t>(end - cur));
+        std::copy(cur, cur + take, dest);
+        cur += take;
+        dest += take;
+        n -= take;
+      }
+    }
+
+    // number of values produced so far
+    uint64_t position() const { return static_cast<uint64_t>(cur - base) + baseOffset; }
+
+    // Jump to pos. Inside the pool this is free; beyond it, live generation restarts from the
+    // saved end state and runs forward.
+    void seek(const uint64_t pos) {
+      live.seed(endState);
+      if (pos < header().words) {
+        base = pool;
+        baseOffset = 0;
+        cur = pool + pos;
+        end = pool + header().words;
+      } else {
+        base = end = cur = buffer;
+        baseOffset = header().words;
+        for (uint64_t skip = pos - header().words; skip > 0;) {
+          std::size_t take = static_cast<std::size_t>(std::min<uint64_t>(skip, kRandSize));
+          refill();
+          cur += take;
+          skip -= take;
+        }
+      }
+    }
+
+    void discard(const unsigned long long n) { seek(position() + n); }
+
+    uint64_t poolSize() const { return header().words; }
+    bool exhausted() const { return base == buffer; }
+    std::string seed() const { return std::string(header().seed, header().seedlen); }
+
+   private:
+    static constexpr const char* kMagic = "ISAACPL1";
+
+    const IsaacPoolHeader& header() const { return *static_cast<const IsaacPoolHeader*>(mapping); }
+
+    // past the end of the pool: serve the next live block through buffer
+    void refill() {
+      baseOffset += static_cast<uint64_t>(end - base);
+      live.generate(buffer, kRandSize);
+      base = cur = buffer;
+      end = buffer + kRandSize;
+    }
+
+    void unmap() {
+      if (mapping != nullptr) ::munmap(mapping, mapLength);
+      mapping = nullptr;
+    }
+
+    Isaac live, endState;
+    void* mapping;
+    std::size_t mapLength;
+    const uint32_t* pool;
+    const uint32_t *base, *cur, *end;  // values are served from [cur, end); base is where position baseOffset sits
+    uint64_t baseOffset;
+    uint32_t buffer[kRandSize];
+  };
+}  // namespace IsaacRNG
+
+#endif
@@ -0,0 +1,324 @@
+#ifndef __ISAAC_RESERVOIR_H__
+#define __ISAAC_RESERVOIR_H__
+
+/**********************************************************************************
+
+  Streaming reservoir sampling driven by ISAAC, for streams too long to hold
+  or of unknown length.
+
+  ReservoirSampler keeps a uniform sample of k items using Li's Algorithm L.
+  Rather than drawing a number for every item, as the classic Algorithm R
+  does, it draws the number of items to pass over before the next one enters
+  the reservoir. The random draws therefore grow as k log(n / k), not n.
+  WeightedReservoirSampler does the same for weighted streams with Efraimidis
+  and Spirakis' A-ExpJ. An item is kept with probability that follows its
+  weight, as if sampled without replacement.
+
+  Both take whole ranges as well as single items. With random access
+  iterators the unweighted sampler jumps straight over the skipped items.
+  Samplers fed on different threads, each with its own engine, can be merged
+  into one sample of the combined stream. That sample is distributed exactly
+  as if one sampler had seen every item, and ingestion can continue after
+  the merge.
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+  --
+
+  N.B. a C++ compiler capable of generating C++14 compliant
+  code is REQUIRED. g++ 5 will work, although g++ 6.1 or higher
+  is preferred.
+
+**********************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "isaac.h"
+#include "isaac_engine.h"
+#include "isaac_util.h"
+
+namespace IsaacRNG {
+  namespace detail {
+    // uniform on the open interval (0, 1) with 53 bits of resolution
+    template <class Engine>
+    double openUniform(Engine& eng) {
+      uint32_t w[2];
+      eng.generate(w, 2);
+      const uint64_t bits = (static_cast<uint64_t>(w[0]) << 21) ^ (w[1] >> 11);
+      return std::ldexp(static_cast<double>(bits) + 0.5, -53);
+    }
+
+    // items to pass over before the next success of a Bernoulli trial with success probability p
+    template <class Engine>
+    uint64_t geometricSkip(Engine& eng, const double p) {
+      const double gap = std::floor(std::log(openUniform(eng)) / std::log1p(-p));
+      return gap < 1e19 ? static_cast<uint64_t>(gap) : UINT64_MAX;
+    }
+
+    inline void checkReservoirSize(const std::size_t k) {
+      if (k == 0 || k > UINT32_MAX) throw std::invalid_argument("reservoir size must be between 1 and 2^32 - 1");
+    }
+  }  // namespace detail
+
+  // Uniform sample of up to k items from a stream, by Algorithm L. Engine is Isaac or
+  // IsaacEngine; give each thread's sampler its own.
+  template <class T, class Engine = IsaacEngine>
+  class ReservoirSampler {
+   public:
+    // throws std::invalid_argument unless 0 < k < 2^32
+    ReservoirSampler(const std::size_t k, Engine& engine) : eng(engine), cap(k), count(0), w(0.0), skip(0) {
+      detail::checkReservoirSize(k);
+      items.reserve(k);
+    }
+
+    void add(const T& item) {
+      count++;
+      if (items.size() < cap) {
+        items.push_back(item);
+        if (items.size() == cap) start();
+      } else if (skip > 0)
+        skip--;
+      else
+        accept(item);
+    }
+
+    // Offer every item in [first, last). Random access ranges only touch the items that are
+    // kept. The sample is the one adding the items one at a time would give.
+    template <class InputIt>
+    void add(InputIt first, InputIt last) {
+      addRange(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    }
+
+    // Fold in other, a sampler of the same size over a disjoint part of the stream. Afterwards
+    // this holds a uniform sample of both streams together; other is left as it was. Draws come
+    // from this sampler's engine. Throws std::invalid_argument if the sizes differ.
+    void merge(const ReservoirSampler& other) {
+      if (other.cap != cap) throw std::invalid_argument("ReservoirSampler: cannot merge samplers of different sizes");
+      if (&other == this) throw std::invalid_argument("ReservoirSampler: cannot merge a sampler into itself");
+
+      // Algorithm L keeps only the largest of the items' uniform keys, as w. Given w the rest
+      // are independent and uniform below it, so keys are drawn afresh for both sides and the
+      // k smallest of them kept.
+      std::vector<std::pair<double, const T*>> keyed;
+      keyed.reserve(items.size() + other.items.size());
+      drawKeys(*this, keyed);
+      drawKeys(other, keyed);
+      if (keyed.size() > cap) {
+        std::nth_element(keyed.begin(), keyed.begin() + static_cast<std::ptrdiff_t>(cap - 1), keyed.end(),
+                         [](const std::pair<double, const T*>& a, const std::pair<double, const T*>& b) { return a.first < b.first; });
+        keyed.resize(cap);
+      }
+
+      std::vector<T> merged;
+      merged.reserve(cap);
+      double largest = 0.0;
+      for (const auto& e : keyed) {
+        merged.push_back(*e.second);
+        largest = std::max(largest, e.first);
+      }
+      items.swap(merged);
+      count += other.count;
+      if (items.size() == cap) {
+        w = largest;
+        skip = detail::geometricSkip(eng, w);
+      }
+    }
+
+    // the items sampled so far, in no particular order
+    const std::vector<T>& sample() const { return items; }
+
+    std::size_t capacity() const { return cap; }
+    std::size_t size() const { return items.size(); }
+    // items offered so far
+    uint64_t seen() const { return count; }
+
+    void clear() {
+      items.clear();
+      count = 0;
+    }
+
+   private:
+    template <class InputIt>
+    void addRange(InputIt first, InputIt last, std::input_iterator_tag) {
+      for (; first != last; ++first) add(*first);
+    }
+
+    template <class RandomIt>
+    void addRange(RandomIt first, RandomIt last, std::random_access_iterator_tag) {
+      using diff_t = typename std::iterator_traits<RandomIt>::difference_type;
+
+      for (; first != last && items.size() < cap; ++first) add(*first);
+      uint64_t n = static_cast<uint64_t>(last - first);
+      count += n;
+      while (skip < n) {
+        first += static_cast<diff_t>(skip);
+        n -= skip + 1;
+        accept(*first++);
+      }
+      skip -= n;
+    }
+
+    // the reservoir has just filled: w is distributed as the largest of k uniform keys
+    void start() {
+      w = std::exp(std::log(detail::openUniform(eng)) / static_cast<double>(cap));
+      skip = detail::geometricSkip(eng, w);
+    }
+
+    // item replaces a random member, and w shrinks to the largest of the k keys now held
+    void accept(const T& item) {
+      items[detail::bounded32(static_cast<uint32_t>(cap), [this]() { return detail::drawOne(eng); })] = item;
+      w *= std::exp(std::log(detail::openUniform(eng)) / static_cast<double>(cap));
+      skip = detail::geometricSkip(eng, w);
+    }
+
+    // the keys of src's items, uniform below its w once it is full and on (0, 1) before
+    void drawKeys(const ReservoirSampler& src, std::vector<std::pair<double, const T*>>& out) {
+      const bool full = src.items.size() == cap;
+      const std::size_t top =
+          full ? detail::bounded32(static_cast<uint32_t>(cap), [this]() { return detail::drawOne(eng); }) : src.items.size();
+      for (std::size_t i = 0; i < src.items.size(); i++) {
+        double key = detail::openUniform(eng);
+        if (full) key = i == top ? src.w : key * src.w;
+        out.emplace_back(key, &src.items[i]);
+      }
+    }
+
+    Engine& eng;
+    std::size_t cap;
+    std::vector<T> items;
+    uint64_t count;
+    double w;       // largest key in the full reservoir
+    uint64_t skip;  // items to pass over before the next is kept
+  };
+
+  // Weighted sample of up to k items from a stream, by A-ExpJ. Each item carries a key
+  // u^(1 / weight) and the k largest keys are kept. Keys are held as logarithms, so very
+  // small and very large weights both keep their precision.
+  template <class T, class Engine = IsaacEngine>
+  class WeightedReservoirSampler {
+   public:
+    // throws std::invalid_argument unless 0 < k < 2^32
+    WeightedReservoirSampler(const std::size_t k, Engine& engine) : eng(engine), cap(k), count(0), total(0.0), gap(0.0) {
+      detail::checkReservoirSize(k);
+      heap.reserve(k);
+    }
+
+    // Offer item with weight >= 0; zero weight items are never kept. Throws
+    // std::invalid_argument for a negative or NaN weight.
+    void add(const T& item, const double weight) {
+      if (!(weight >= 0.0)) throw std::invalid_argument("WeightedReservoirSampler: weights must be non-negative");
+      count++;
+      total += weight;
+      if (weight == 0.0) return;
+      if (heap.size() < cap) {
+        heap.push_back(Entry{std::log(detail::openUniform(eng)) / weight, item});
+        std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+        if (heap.size() == cap) jump();
+        return;
+      }
+      gap -= weight;
+      if (gap <= 0.0) accept(item, weight);
+    }
+
+    // Offer every item in [first, last), weighted by the matching element of the range starting
+    // at weights. Items are only read when they are kept.
+    template <class InputIt, class WeightIt>
+    void add(InputIt first, InputIt last, WeightIt weights) {
+      for (; first != last && heap.size() < cap; ++first, ++weights) add(*first, static_cast<double>(*weights));
+      // running sums live in locals so the loop does not write through this for every item
+      double left = gap, sum = 0.0;
+      uint64_t offered = 0;
+      for (; first != last; ++first, ++weights) {
+        const double weight = static_cast<double>(*weights);
+        if (!(weight >= 0.0)) break;
+        offered++;
+        sum += weight;
+        left -= weight;
+        if (left <= 0.0 && weight > 0.0) {
+          accept(*first, weight);
+          left = gap;
+        }
+      }
+      gap = left;
+      count += offered;
+      total += sum;
+      if (first != last) throw std::invalid_argument("WeightedReservoirSampler: weights must be non-negative");
+    }
+
+    // Fold in other, a sampler of the same size over a disjoint part of the stream. Keys are
+    // kept with the items, so this keeps the k largest of both sides. Draws come from this
+    // sampler's engine. Throws std::invalid_argument if the sizes differ.
+    void merge(const WeightedReservoirSampler& other) {
+      if (other.cap != cap) throw std::invalid_argument("WeightedReservoirSampler: cannot merge samplers of different sizes");
+      if (&other == this) throw std::invalid_argument("WeightedReservoirSampler: cannot merge a sampler into itself");
+
+      heap.insert(heap.end(), other.heap.begin(), other.heap.end());
+      if (heap.size() > cap) {
+        std::nth_element(heap.begin(), heap.begin() + static_cast<std::ptrdiff_t>(cap - 1), heap.end(), std::greater<Entry>());
+        heap.resize(cap);
+      }
+      std::make_heap(heap.begin(), heap.end(), std::greater<Entry>());
+      count += other.count;
+      total += other.total;
+      if (heap.size() == cap) jump();
+    }
+
+    // the items sampled so far, in no particular order
+    std::vector<T> sample() const {
+      std::vector<T> out;
+      out.reserve(heap.size());
+      for (const Entry& e : heap) out.push_back(e.item);
+      return out;
+    }
+
+    std::size_t capacity() const { return cap; }
+    std::size_t size() const { return heap.size(); }
+    // items offered so far, and the sum of their weights
+    uint64_t seen() const { return count; }
+    double totalWeight() const { return total; }
+
+    void clear() {
+      heap.clear();
+      count = 0;
+      total = 0.0;
+    }
+
+   private:
+    struct Entry {
+      double key;  // log of u^(1 / weight)
+      T item;
+      bool operator>(const Entry& rhs) const { return key > rhs.key; }
+    };
+
+    // the weight to pass over before the next item is kept, given the smallest key held
+    void jump() { gap = std::log(detail::openUniform(eng)) / heap.front().key; }
+
+    // item replaces the smallest key, with a key of its own drawn from above that key
+    void accept(const T& item, const double weight) {
+      const double least = std::exp(heap.front().key * weight);
+      const double u = least + (1.0 - least) * detail::openUniform(eng);
+      std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+      heap.back() = Entry{std::log(u) / weight, item};
+      std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+      jump();
+    }
+
+    Engine& eng;
+    std::size_t cap;
+    std::vector<Entry> heap;  // min-heap on key
+    uint64_t count;
+    double total;
+    double gap;  // weight still to pass over before the next item is kept
+  };
+}  // namespace IsaacRNG
+
+#endif
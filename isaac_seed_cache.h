@@ -0,0 +1,255 @@
+#ifndef __ISAAC_SEED_CACHE_H__
+#define __ISAAC_SEED_CACHE_H__
+
+/**********************************************************************************
+
+  Process-wide cache of expanded ISAAC states keyed on seed bytes.
+
+  Seeding from a key runs randinit() (four mix rounds, two passes over the
+  state) and a first isaac() call. When the same keys are used over and over,
+  SeedCache keeps the finished state so that Isaac::seed(const char*, size_t),
+  and so IsaacEngine's string constructor and seed(), can copy it instead.
+  A cached state is an exact copy, so output sequences are unchanged.
+
+  The cache is off until SeedCache::global().enable() is called. It is a
+  sharded LRU, safe to use from any number of threads. The capacity bounds
+  the whole cache; when it is full a new entry evicts the least recently used
+  entry of its own shard. Keys and states are secrets, so they are zeroed
+  before their memory is released.
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+  --
+
+  N.B. a C++ compiler capable of generating C++14 compliant
+  code is REQUIRED. g++ 5 will work, although g++ 6.1 or higher
+  is preferred.
+
+**********************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "isaac.h"
+
+namespace IsaacRNG {
+  namespace detail {
+    // zeroes n bytes at p through volatile writes, so the stores are not dropped as dead
+    inline void secureZero(void* p, std::size_t n) {
+      volatile unsigned char* v = static_cast<volatile unsigned char*>(p);
+      while (n-- > 0) *v++ = 0;
+    }
+  }  // namespace detail
+
+  const std::size_t kDefaultSeedCacheCapacity = 1024;  // entries of roughly 2 KiB each
+
+  struct SeedCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    std::size_t entries;
+  };
+
+  class SeedCache : public SeedExpansionCache {
+   public:
+    static const std::size_t kShards = 16;
+
+    // The one cache Isaac consults. It is never destroyed, so enabling it from any thread at
+    // any time is safe.
+    static SeedCache& global() {
+      static SeedCache* const cache = new SeedCache();
+      return *cache;
+    }
+
+    SeedCache(const SeedCache&) = delete;
+    SeedCache& operator=(const SeedCache&) = delete;
+
+    void enable() { activeSeedCache().store(this, std::memory_order_release); }
+    void disable() {
+      SeedExpansionCache* self = this;
+      activeSeedCache().compare_exchange_strong(self, nullptr, std::memory_order_acq_rel);
+    }
+    bool enabled() const { return activeSeedCache().load(std::memory_order_acquire) == this; }
+
+    // at most capacity entries are kept in all; shrinking evicts the least recently used of each shard
+    void setCapacity(const std::size_t capacity) {
+      limit.store(capacity, std::memory_order_relaxed);
+      while (size.load(std::memory_order_relaxed) > capacity) {
+        for (auto& shard : shards) {
+          std::lock_guard<std::mutex> lock(shard.mutex);
+          while (size.load(std::memory_order_relaxed) > capacity && !shard.lru.empty()) evictOldest(shard);
+        }
+      }
+    }
+
+    // drops every entry, zeroing its key and state
+    void clear() {
+      for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        size.fetch_sub(shard.lru.size(), std::memory_order_relaxed);
+        shard.lru.clear();
+      }
+    }
+
+    SeedCacheStats stats() const {
+      SeedCacheStats st;
+      st.hits = hits.load(std::memory_order_relaxed);
+      st.misses = misses.load(std::memory_order_relaxed);
+      st.evictions = evictions.load(std::memory_order_relaxed);
+      st.entries = 0;
+      for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        st.entries += shard.lru.size();
+      }
+      return st;
+    }
+
+    void resetStats() {
+      hits.store(0, std::memory_order_relaxed);
+      misses.store(0, std::memory_order_relaxed);
+      evictions.store(0, std::memory_order_relaxed);
+    }
+
+    bool fetch(const char* key, const std::size_t keylen, Isaac& into) override {
+      const KeyRef k = makeKey(key, keylen);
+      Shard& shard = shardFor(k);
+      {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(k);
+        if (it != shard.index.end()) {
+          shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+          const Entry& e = *it->second;
+          std::copy(e.mem, e.mem + kRandSize, into.randmem);
+          std::copy(e.rsl, e.rsl + kRandSize, into.randrsl);
+          into.randa = e.a;
+          into.randb = e.b;
+          into.randc = e.c;
+          into.randcnt = e.cnt;
+          into.pending = false;
+          hits.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+      }
+      misses.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    void store(const char* key, const std::size_t keylen, const Isaac& from) override {
+      const KeyRef k = makeKey(key, keylen);
+      Shard& shard = shardFor(k);
+      {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.index.find(k) != shard.index.end()) return;
+      }
+      if (!reserve(shard)) return;
+
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      if (shard.index.find(k) != shard.index.end()) {
+        size.fetch_sub(1, std::memory_order_relaxed);
+        return;
+      }
+      shard.lru.emplace_front();
+      Entry& e = shard.lru.front();
+      e.key.assign(key, keylen);
+      std::copy(from.randmem, from.randmem + kRandSize, e.mem);
+      std::copy(from.randrsl, from.randrsl + kRandSize, e.rsl);
+      e.a = from.randa;
+      e.b = from.randb;
+      e.c = from.randc;
+      e.cnt = from.randcnt;
+      shard.index.emplace(KeyRef{e.key.data(), e.key.size(), k.hash}, shard.lru.begin());
+    }
+
+   private:
+    struct Entry {
+      std::string key;
+      uint32_t mem[kRandSize];
+      uint32_t rsl[kRandSize];
+      uint32_t a, b, c, cnt;
+      ~Entry() {
+        detail::secureZero(&key[0], key.size());
+        detail::secureZero(mem, sizeof(mem));
+        detail::secureZero(rsl, sizeof(rsl));
+        for (uint32_t* w : {&a, &b, &c, &cnt}) detail::secureZero(w, sizeof(*w));
+      }
+    };
+
+    // the seed bytes of a lookup or of an entry, which owns them; the index holds no copy of its own
+    struct KeyRef {
+      const char* data;
+      std::size_t len;
+      std::size_t hash;
+      bool operator==(const KeyRef& rhs) const { return len == rhs.len && std::equal(data, data + len, rhs.data); }
+    };
+    struct KeyHash {
+      std::size_t operator()(const KeyRef& k) const { return k.hash; }
+    };
+
+    struct Shard {
+      mutable std::mutex mutex;
+      std::list<Entry> lru;
+      std::unordered_map<KeyRef, std::list<Entry>::iterator, KeyHash> index;
+    };
+
+    SeedCache() : limit(kDefaultSeedCacheCapacity), size(0), hits(0), misses(0), evictions(0) {}
+
+    // FNV-1a over the seed bytes
+    static KeyRef makeKey(const char* key, const std::size_t keylen) {
+      uint64_t h = 14695981039346656037ULL;
+      for (std::size_t i = 0; i < keylen; i++) h = (h ^ static_cast<unsigned char>(key[i])) * 1099511628211ULL;
+      return KeyRef{key, keylen, static_cast<std::size_t>(h ^ (h >> 32))};
+    }
+
+    Shard& shardFor(const KeyRef& k) { return shards[k.hash % kShards]; }
+
+    // Claims room for one more entry, evicting from home first and then from the other shards
+    // while the cache is full. Only one shard is locked at a time. False if nothing is left to
+    // evict, as when the capacity is zero.
+    bool reserve(Shard& home) {
+      const std::size_t first = static_cast<std::size_t>(&home - shards);
+      std::size_t n = size.load(std::memory_order_relaxed);
+      for (;;) {
+        if (n < limit.load(std::memory_order_relaxed)) {
+          if (size.compare_exchange_weak(n, n + 1, std::memory_order_relaxed)) return true;
+          continue;
+        }
+        bool evicted = false;
+        for (std::size_t i = 0; i < kShards && !evicted; i++) {
+          Shard& shard = shards[(first + i) % kShards];
+          std::lock_guard<std::mutex> lock(shard.mutex);
+          if (!shard.lru.empty()) {
+            evictOldest(shard);
+            evicted = true;
+          }
+        }
+        if (!evicted) return false;
+        n = size.load(std::memory_order_relaxed);
+      }
+    }
+
+    // shard is locked and not empty
+    void evictOldest(Shard& shard) {
+      const Entry& e = shard.lru.back();
+      shard.index.erase(makeKey(e.key.data(), e.key.size()));
+      shard.lru.pop_back();
+      size.fetch_sub(1, std::memory_order_relaxed);
+      evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Shard shards[kShards];
+    std::atomic<std::size_t> limit, size;  // entry bound, and entries held or claimed
+    std::atomic<uint64_t> hits, misses, evictions;
+  };
+}  // namespace IsaacRNG
+
+#endif
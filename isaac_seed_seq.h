@@ -0,0 +1,139 @@
+#ifndef __ISAAC_SEED_SEQ_H__
+#define __ISAAC_SEED_SEQ_H__
+
+/**********************************************************************************
+
+  A SeedSequence for seeding ISAAC from short keys.
+
+  std::seed_seq::generate makes several scrambling passes over its output
+  range, which is slow when it has to fill a whole ISAAC seed block, and
+  slower still when it seeds many engines. ISAAC's own randinit() already
+  mixes its seed thoroughly, so IsaacSeedSeq does much less work. It folds
+  the key into a 64-bit digest once. Each output word is then one half of a
+  counter-based hash of that digest, plus the key word at that position,
+  repeating the key as needed. A key of 256 words or more therefore reaches
+  the engine with none of its entropy lost.
+
+  The expanded stream is unbounded and can be read at any offset, so
+  seedEngines() gives each engine in a range its own 256-word slice of it.
+
+  Like std::seed_seq this spreads key material over a seed; it is not a key
+  derivation function.
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+  --
+
+  N.B. a C++ compiler capable of generating C++14 compliant
+  code is REQUIRED. g++ 5 will work, although g++ 6.1 or higher
+  is preferred.
+
+**********************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+#include "isaac.h"
+
+namespace IsaacRNG {
+  class IsaacSeedSeq {
+   public:
+    using result_type = uint32_t;
+
+    IsaacSeedSeq() { init(); }
+    template <class InputIt>
+    IsaacSeedSeq(InputIt first, InputIt last) {
+      for (; first != last; ++first) key.push_back(static_cast<uint32_t>(*first));
+      init();
+    }
+    template <class T>
+    IsaacSeedSeq(std::initializer_list<T> il) : IsaacSeedSeq(il.begin(), il.end()) {}
+
+    // fill [first, last) with the stream from its start, as std::seed_seq::generate does
+    template <class RandomIt>
+    void generate(RandomIt first, RandomIt last) const {
+      generate(first, last, 0);
+    }
+
+    // fill [first, last) with the stream from word offset onwards
+    template <class RandomIt>
+    void generate(RandomIt first, RandomIt last, const uint64_t offset) const {
+      const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+      std::size_t i = 0;
+      std::size_t k = key.empty() ? 0 : static_cast<std::size_t>(offset % key.size());
+      uint64_t pair = offset / 2;
+      if (n > 0 && offset % 2 == 1) {
+        first[0] = static_cast<uint32_t>(hash(pair++) >> 32) + keyWord(k);
+        i = 1;
+      }
+      for (; i + 1 < n; i += 2, pair++) {
+        const uint64_t h = hash(pair);
+        first[i] = static_cast<uint32_t>(h) + keyWord(k);
+        first[i + 1] = static_cast<uint32_t>(h >> 32) + keyWord(k);
+      }
+      if (i < n) first[i] = static_cast<uint32_t>(hash(pair)) + keyWord(k);
+    }
+
+    // Seed each Isaac or IsaacEngine in [first, last) from its own consecutive run of
+    // kRandSize words, the first from the start of the stream.
+    template <class EngineIt>
+    void seedEngines(EngineIt first, EngineIt last) const {
+      for (uint64_t offset = 0; first != last; ++first, offset += kRandSize) {
+        Window window{this, offset};
+        first->seed(window);
+      }
+    }
+
+    std::size_t size() const { return key.size(); }
+
+    template <class OutputIt>
+    void param(OutputIt out) const {
+      std::copy(key.begin(), key.end(), out);
+    }
+
+   private:
+    static const uint64_t kGamma = 0x9e3779b97f4a7c15ULL;
+
+    // the stream at a fixed offset, as a SeedSequence an engine can seed from
+    struct Window {
+      const IsaacSeedSeq* seq;
+      uint64_t offset;
+      template <class RandomIt>
+      void generate(RandomIt first, RandomIt last) {
+        seq->generate(first, last, offset);
+      }
+    };
+
+    // SplitMix64's output function
+    static uint64_t mix(uint64_t z) {
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      return z ^ (z >> 31);
+    }
+
+    void init() {
+      digest = mix(key.size() * kGamma);
+      for (uint32_t w : key) digest = mix(digest + w + kGamma);
+    }
+
+    uint64_t hash(const uint64_t pair) const { return mix(digest + (pair + 1) * kGamma); }
+
+    // the key word for the current position, stepping k on to the next
+    uint32_t keyWord(std::size_t& k) const {
+      if (key.empty()) return 0;
+      const uint32_t w = key[k];
+      if (++k == key.size()) k = 0;
+      return w;
+    }
+
+    std::vector<uint32_t> key;
+    uint64_t digest;
+  };
+}  // namespace IsaacRNG
+
+#endif
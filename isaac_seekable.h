@@ -0,0 +1,260 @@
+#ifndef __ISAAC_SEEKABLE_H__
+#define __ISAAC_SEEKABLE_H__
+
+/**********************************************************************************
+
+  Random access into an ISAAC stream. ISAAC has no jump-ahead, so SeekableIsaac
+  records a compact checkpoint of the generator state every K blocks as it runs
+  and seeks by restoring the nearest earlier checkpoint and regenerating at
+  most K blocks from there.
+
+  Checkpoints are kept in a store. MemoryCheckpointStore keeps them in memory;
+  FileCheckpointStore keeps them in a file that can be reopened later, so that
+  a replay run can seek straight to a position another run already passed.
+  Checkpoint files are written in host byte order.
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+  --
+
+  N.B. a C++ compiler capable of generating C++14 compliant
+  code is REQUIRED. g++ 5 will work, although g++ 6.1 or higher
+  is preferred.
+
+**********************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "isaac.h"
+
+namespace IsaacRNG {
+  const uint32_t kDefaultCheckpointInterval = 1024;  // blocks, i.e. a checkpoint every 256Ki values
+
+  // generator state immediately before a block is generated
+  struct IsaacCheckpoint {
+    uint32_t mem[kRandSize];
+    uint32_t a, b, c;
+  };
+
+  class MemoryCheckpointStore {
+   public:
+    void bind(const uint32_t, const uint32_t* const) {}
+    std::size_t size() const { return checkpoints.size(); }
+    void append(const IsaacCheckpoint& cp) { checkpoints.push_back(cp); }
+    void load(const std::size_t index, IsaacCheckpoint& cp) { cp = checkpoints[index]; }
+
+   private:
+    std::vector<IsaacCheckpoint> checkpoints;
+  };
+
+  class FileCheckpointStore {
+   public:
+    static const std::size_t kFingerprintWords = 4;
+
+    // Opens path for reading and appending, creating it if need be. An existing file is only
+    // reused if it was written for the same stream and interval; bind() throws otherwise.
+    explicit FileCheckpointStore(const std::string& path) : count(0) {
+      file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+      if (!file.is_open()) {
+        std::ofstream create(path, std::ios::binary);
+        create.close();
+        file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+      }
+      if (!file.is_open()) throw std::runtime_error("FileCheckpointStore: cannot open " + path);
+    }
+    FileCheckpointStore(const FileCheckpointStore&) = delete;
+    FileCheckpointStore& operator=(const FileCheckpointStore&) = delete;
+
+    void bind(const uint32_t interval, const uint32_t* const fingerprint) {
+      Header want;
+      std::memcpy(want.magic, kMagic, sizeof(want.magic));
+      want.interval = interval;
+      std::copy(fingerprint, fingerprint + kFingerprintWords, want.fingerprint);
+
+      file.seekg(0, std::ios::end);
+      std::streamoff length = file.tellg();
+      if (length < static_cast<std::streamoff>(sizeof(Header))) {
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&want), sizeof(want));
+        file.flush();
+        count = 0;
+      } else {
+        Header have;
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(&have), sizeof(have));
+        if (!file || std::memcmp(&have, &want, sizeof(Header)) != 0)
+          throw std::runtime_error("FileCheckpointStore: file was written for a different stream or interval");
+        // a torn final record from an interrupted run is ignored and later overwritten
+        count = static_cast<std::size_t>(length - static_cast<std::streamoff>(sizeof(Header))) / sizeof(IsaacCheckpoint);
+      }
+      if (!file) throw std::runtime_error("FileCheckpointStore: I/O error");
+    }
+
+    std::size_t size() const { return count; }
+
+    void append(const IsaacCheckpoint& cp) {
+      file.seekp(offset(count));
+      file.write(reinterpret_cast<const char*>(&cp), sizeof(cp));
+      file.flush();
+      if (!file) throw std::runtime_error("FileCheckpointStore: I/O error");
+      count++;
+    }
+
+    void load(const std::size_t index, IsaacCheckpoint& cp) {
+      file.seekg(offset(index));
+      file.read(reinterpret_cast<char*>(&cp), sizeof(cp));
+      if (!file) throw std::runtime_error("FileCheckpointStore: I/O error");
+    }
+
+   private:
+    struct Header {
+      char magic[8];
+      uint32_t interval;
+      uint32_t fingerprint[kFingerprintWords];
+    };
+
+    static constexpr const char* kMagic = "ISAACCKP";
+
+    static std::streamoff offset(const std::size_t index) {
+      return static_cast<std::streamoff>(sizeof(Header) + index * sizeof(IsaacCheckpoint));
+    }
+
+    std::fstream file;
+    std::size_t count;
+  };
+
+  // A UniformRandomBitGenerator over an Isaac stream that can seek to any position. Position 0
+  // is the first value the generator produces after seeding (or the next value of the Isaac it
+  // was constructed from). Seeking costs at most interval block generations.
+  template <class Store = MemoryCheckpointStore>
+  class SeekableIsaac {
+   public:
+    using result_type = uint32_t;
+    static constexpr result_type(min)() { return 0; }
+    static constexpr result_type(max)() { return UINT32_MAX; }
+
+    explicit SeekableIsaac(const uint32_t interval = kDefaultCheckpointInterval) : SeekableIsaac(Isaac(), interval) {}
+    SeekableIsaac(const uint32_t* const seedArr, const std::size_t seedlen, const uint32_t interval = kDefaultCheckpointInterval)
+        : SeekableIsaac(Isaac(seedArr, seedlen), interval) {}
+    SeekableIsaac(const char* const seedArr, const std::size_t seedlen, const uint32_t interval = kDefaultCheckpointInterval)
+        : SeekableIsaac(Isaac(seedArr, seedlen), interval) {}
+    explicit SeekableIsaac(const Isaac& start, const uint32_t interval = kDefaultCheckpointInterval)
+        : origin(start), prng(start), ownStore(new Store()), store(ownStore.get()) {
+      init(interval);
+    }
+
+    // variants with an externally owned store such as a FileCheckpointStore
+    SeekableIsaac(const uint32_t* const seedArr, const std::size_t seedlen, const uint32_t interval, Store& st)
+        : SeekableIsaac(Isaac(seedArr, seedlen), interval, st) {}
+    SeekableIsaac(const char* const seedArr, const std::size_t seedlen, const uint32_t interval, Store& st)
+        : SeekableIsaac(Isaac(seedArr, seedlen), interval, st) {}
+    SeekableIsaac(const Isaac& start, const uint32_t interval, Store& st) : origin(start), prng(start), store(&st) {
+      init(interval);
+    }
+
+    SeekableIsaac(const SeekableIsaac&) = delete;
+    SeekableIsaac& operator=(const SeekableIsaac&) = delete;
+
+    result_type operator()() {
+      if (prng.randcnt == 0) advance();
+      return prng.randrsl[--prng.randcnt];
+    }
+
+    void generate(result_type* dest, std::size_t n) {
+      while (n > 0) {
+        if (prng.randcnt == 0) advance();
+        std::size_t take = std::min(n, static_cast<std::size_t>(prng.randcnt));
+        std::reverse_copy(prng.randrsl + prng.randcnt - take, prng.randrsl + prng.randcnt, dest);
+        prng.randcnt -= static_cast<uint32_t>(take);
+        dest += take;
+        n -= take;
+      }
+    }
+
+    // number of values produced since position 0
+    uint64_t position() const { return (block + 1) * kRandSize - prng.randcnt - originOffset; }
+
+    void seek(const uint64_t pos) {
+      const uint64_t abs = pos + originOffset;
+      const uint64_t target = abs / kRandSize;
+
+      if (target != block) {
+        const uint64_t cp = std::min<uint64_t>(target / interval, store->size());
+        // keep generating from where we are if that is no further than from the checkpoint
+        if (target < block || block + 1 < cp * interval) {
+          if (cp == 0) {
+            prng.seed(origin);
+            block = 0;
+          } else {
+            IsaacCheckpoint state;
+            store->load(static_cast<std::size_t>(cp - 1), state);
+            std::copy(state.mem, state.mem + kRandSize, prng.randmem);
+            prng.randa = state.a;
+            prng.randb = state.b;
+            prng.randc = state.c;
+            block = cp * interval - 1;
+          }
+        }
+        while (block < target) advance();
+      }
+
+      prng.randcnt = static_cast<uint32_t>(kRandSize - abs % kRandSize);
+    }
+
+    void discard(const unsigned long long n) { seek(position() + n); }
+
+    uint32_t checkpointInterval() const { return interval; }
+    std::size_t checkpoints() const { return store->size(); }
+
+   private:
+    void init(const uint32_t blocks) {
+      if (blocks == 0) throw std::invalid_argument("SeekableIsaac: checkpoint interval must be positive");
+      interval = blocks;
+      block = 0;
+      // a lazily seeded start is expanded here, as advance() refills prng directly
+      origin.settle();
+      prng.settle();
+      originOffset = kRandSize - origin.randcnt;
+
+      uint32_t fingerprint[FileCheckpointStore::kFingerprintWords];
+      Isaac probe(origin);
+      probe.generate(fingerprint, FileCheckpointStore::kFingerprintWords);
+      store->bind(interval, fingerprint);
+    }
+
+    // generate block + 1, first recording a checkpoint if one is due and not yet stored
+    void advance() {
+      const uint64_t next = block + 1;
+      if (next % interval == 0 && next / interval == store->size() + 1) {
+        IsaacCheckpoint state;
+        std::copy(prng.randmem, prng.randmem + kRandSize, state.mem);
+        state.a = prng.randa;
+        state.b = prng.randb;
+        state.c = prng.randc;
+        store->append(state);
+      }
+      prng.isaac();
+      prng.randcnt = kRandSize;
+      block = next;
+    }
+
+    Isaac origin;
+    Isaac prng;
+    std::unique_ptr<Store> ownStore;
+    Store* store;
+    uint32_t interval;
+    uint64_t block;  // index of the block currently in prng.randrsl, counted from origin
+    uint64_t originOffset;
+  };
+}  // namespace IsaacRNG
+
+#endif
@@ -0,0 +1,365 @@
+#ifndef __ISAAC_SHM_H__
+#define __ISAAC_SHM_H__
+
+/**********************************************************************************
+
+  One ISAAC producer serving many processes through POSIX shared memory.
+
+  IsaacShmProducer creates a named shared-memory ring of output blocks and
+  keeps it topped up from a single Isaac. IsaacShmClient attaches to the ring
+  from any process and hands out the words of the blocks it leases as a
+  UniformRandomBitGenerator. Every block goes to exactly one client.
+
+  Leasing takes no lock. Blocks are numbered. A client reads the next unleased
+  block number and copies that block out of its slot. It then claims the block
+  by advancing the shared lease counter with a compare-and-swap. If the swap
+  fails, another client took the block first and the copy is thrown away. The
+  producer only refills a slot once the block in it has been leased, so a
+  successful swap always follows a clean copy. No client ever holds anything
+  another process waits on, so a client that dies at any point, even mid
+  lease, leaves the ring fully usable. A client that finds the ring empty for
+  long checks that the producer is still alive, and throws if it is not.
+
+  A producer claims its name for as long as it runs by holding an exclusive
+  flock() on a lock file in /tmp named after the ring. The kernel drops the
+  lock when the producer exits, however it exits. So a producer that gets the
+  lock knows any segment of that name is stale and may replace it, and a
+  producer that cannot get it knows the ring is live. A producer that shuts
+  down removes its segment and then its lock file. Children forked by a
+  producer share its lock until they exit or exec.
+
+  Segments are readable and writable by the creating user only. POSIX shm_open
+  and mmap, flock(), and lock-free 64-bit atomics, are required.
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+  --
+
+  N.B. a C++ compiler capable of generating C++14 compliant
+  code is REQUIRED. g++ 5 will work, although g++ 6.1 or higher
+  is preferred.
+
+**********************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "isaac.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#error "isaac_shm.h requires POSIX shared memory"
+#endif
+
+namespace IsaacRNG {
+  const uint32_t kShmVersion = 1;
+  const uint32_t kDefaultShmSlots = 64;  // blocks in the ring, 64 KiB of output
+
+  static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2, "isaac_shm.h requires lock-free atomics");
+
+  struct IsaacShmHeader {
+    char magic[8];
+    std::atomic<uint32_t> version;  // stored last by the producer, so nonzero only once the ring is ready
+    uint32_t slots;
+    std::atomic<int32_t> producerPid;  // zero once the producer has shut down
+    alignas(64) std::atomic<uint64_t> leased;  // blocks handed out so far, i.e. the next block to lease
+  };
+
+  struct alignas(64) IsaacShmSlot {
+    std::atomic<uint64_t> seq;  // one more than the number of the block held, or the slot index before the first
+    // Atomic because a client may copy a slot while the producer refills it; the client's lease
+    // then fails and the copy is discarded. Relaxed accesses suffice, as seq orders them.
+    std::atomic<uint32_t> data[kRandSize];
+  };
+
+  namespace detail {
+    // spin briefly, then yield, then sleep; used by both sides when the ring is full or empty
+    class ShmBackoff {
+     public:
+      ShmBackoff() : rounds(0) {}
+
+      // true roughly every 50 ms of sleeping, when a waiter should check on the other side
+      bool wait() {
+        rounds++;
+        if (rounds < 64) return false;
+        if (rounds < 128) {
+          std::this_thread::yield();
+          return false;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        return (rounds - 128) % 1000 == 999;
+      }
+
+      void reset() { rounds = 0; }
+
+     private:
+      uint64_t rounds;
+    };
+
+    inline std::size_t shmSize(const uint32_t slots) { return sizeof(IsaacShmHeader) + slots * sizeof(IsaacShmSlot); }
+
+    inline IsaacShmSlot* shmSlots(IsaacShmHeader* header) {
+      return reinterpret_cast<IsaacShmSlot*>(reinterpret_cast<char*>(header) + sizeof(IsaacShmHeader));
+    }
+
+    constexpr const char* kShmMagic = "ISAACSHM";
+
+    // the lock file a producer holds while it serves name, e.g. /tmp/isaac.isaac-shm.lock for "/isaac"
+    inline std::string shmLockPath(const std::string& name) {
+      std::string file = name.size() > 0 && name[0] == '/' ? name.substr(1) : name;
+      std::replace(file.begin(), file.end(), '/', '_');
+      return "/tmp/" + file + ".isaac-shm.lock";
+    }
+
+    // false only if no process pid exists; one that exists but may not be signalled is alive
+    inline bool processAlive(const int32_t pid) {
+      return pid != 0 && (::kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH);
+    }
+  }  // namespace detail
+
+  class IsaacShmProducer {
+   public:
+    // Create the ring called name (a POSIX shared memory name such as "/isaac"), replacing any
+    // segment of that name left behind by a producer that has gone, and fill it from start.
+    // Throws std::runtime_error, including when a running producer already serves name.
+    IsaacShmProducer(const std::string& name, const Isaac& start, const uint32_t slots = kDefaultShmSlots)
+        : shmName(name), prng(start), lockFd(-1), next(0) {
+      create(slots);
+    }
+    // as above, seeded from std::random_device
+    explicit IsaacShmProducer(const std::string& name, const uint32_t slots = kDefaultShmSlots)
+        : shmName(name), lockFd(-1), next(0) {
+      std::random_device rd;
+      prng.seed(rd);
+      create(slots);
+    }
+
+    IsaacShmProducer(const IsaacShmProducer&) = delete;
+    IsaacShmProducer& operator=(const IsaacShmProducer&) = delete;
+
+    // Clients already attached keep their mapping and drain what is left, then find the
+    // producer gone.
+    ~IsaacShmProducer() {
+      header->producerPid.store(0, std::memory_order_release);
+      ::munmap(header, detail::shmSize(header->slots));
+      ::shm_unlink(shmName.c_str());
+      // both while still locked, so a successor never unlinks a live segment
+      ::unlink(detail::shmLockPath(shmName).c_str());
+      ::close(lockFd);
+    }
+
+    // fill every slot whose block has been leased, without waiting; returns the number filled
+    std::size_t produce() {
+      const uint64_t slots = header->slots;
+      std::size_t filled = 0;
+      // block next may replace block next - slots only once that has been leased
+      uint32_t block[kRandSize];
+      while (next < slots || header->leased.load(std::memory_order_acquire) + slots > next) {
+        IsaacShmSlot& slot = detail::shmSlots(header)[next % slots];
+        prng.generate(block, kRandSize);
+        for (std::size_t i = 0; i < kRandSize; i++) slot.data[i].store(block[i], std::memory_order_relaxed);
+        slot.seq.store(next + 1, std::memory_order_release);
+        next++;
+        filled++;
+      }
+      return filled;
+    }
+
+    // keep the ring full until stop is set
+    void run(const std::atomic<bool>& stop) {
+      detail::ShmBackoff backoff;
+      while (!stop.load(std::memory_order_relaxed)) {
+        if (produce() > 0)
+          backoff.reset();
+        else
+          backoff.wait();
+      }
+    }
+
+    uint64_t produced() const { return next; }
+    uint64_t leased() const { return header->leased.load(std::memory_order_relaxed); }
+    const std::string& name() const { return shmName; }
+
+   private:
+    void create(const uint32_t slots) {
+      if (slots < 2) throw std::invalid_argument("IsaacShmProducer: a ring needs at least two slots");
+      claim();
+      // holding the claim, any segment of this name is one whose producer has gone
+      ::shm_unlink(shmName.c_str());
+      int fd = ::shm_open(shmName.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+      if (fd < 0) {
+        ::close(lockFd);
+        throw std::runtime_error("IsaacShmProducer: cannot create " + shmName);
+      }
+      const std::size_t size = detail::shmSize(slots);
+      void* addr = MAP_FAILED;
+      if (::ftruncate(fd, static_cast<off_t>(size)) == 0) addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      ::close(fd);
+      if (addr == MAP_FAILED) {
+        ::shm_unlink(shmName.c_str());
+        ::close(lockFd);
+        throw std::runtime_error("IsaacShmProducer: cannot map " + shmName);
+      }
+
+      header = new (addr) IsaacShmHeader;
+      header->version.store(0, std::memory_order_relaxed);
+      std::memcpy(header->magic, detail::kShmMagic, sizeof(header->magic));
+      header->slots = slots;
+      header->producerPid.store(static_cast<int32_t>(::getpid()), std::memory_order_relaxed);
+      header->leased.store(0, std::memory_order_relaxed);
+      IsaacShmSlot* ring = detail::shmSlots(header);
+      for (uint32_t i = 0; i < slots; i++) new (&ring[i]) IsaacShmSlot;
+      for (uint32_t i = 0; i < slots; i++) ring[i].seq.store(i, std::memory_order_relaxed);
+      produce();
+      // clients load the version first, so they never see a half-built ring
+      header->version.store(kShmVersion, std::memory_order_release);
+    }
+
+    // Take the exclusive lock on shmName's lock file, which is held until destruction. A
+    // departing producer unlinks the file while it holds the lock, so a lock taken on a file
+    // that is no longer at path is worthless and the claim starts over.
+    void claim() {
+      const std::string path = detail::shmLockPath(shmName);
+      for (;;) {
+        lockFd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, S_IRUSR | S_IWUSR);
+        if (lockFd < 0) throw std::runtime_error("IsaacShmProducer: cannot open lock file " + path);
+        int rc;
+        do rc = ::flock(lockFd, LOCK_EX | LOCK_NB);
+        while (rc != 0 && errno == EINTR);
+        if (rc != 0) {
+          const bool held = errno == EWOULDBLOCK;
+          ::close(lockFd);
+          if (held) throw std::runtime_error("IsaacShmProducer: " + shmName + " is served by a running producer");
+          throw std::runtime_error("IsaacShmProducer: cannot lock " + path);
+        }
+        struct stat locked, current;
+        if (::fstat(lockFd, &locked) == 0 && ::stat(path.c_str(), &current) == 0 && locked.st_dev == current.st_dev &&
+            locked.st_ino == current.st_ino)
+          return;
+        ::close(lockFd);
+      }
+    }
+
+    std::string shmName;
+    Isaac prng;
+    int lockFd;  // holds the flock() claiming shmName
+    IsaacShmHeader* header;
+    uint64_t next;  // number of the next block to generate
+  };
+
+  // A UniformRandomBitGenerator serving words from blocks leased from an IsaacShmProducer's ring.
+  class IsaacShmClient {
+   public:
+    using result_type = uint32_t;
+    static constexpr result_type(min)() { return 0; }
+    static constexpr result_type(max)() { return UINT32_MAX; }
+
+    // attach to the ring called name; throws std::runtime_error if there is none
+    explicit IsaacShmClient(const std::string& name) : cur(buffer), end(buffer), leaseCount(0) {
+      int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+      if (fd < 0) throw std::runtime_error("IsaacShmClient: no ring called " + name);
+      struct stat st;
+      void* addr = MAP_FAILED;
+      if (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= sizeof(IsaacShmHeader)) {
+        mapLength = static_cast<std::size_t>(st.st_size);
+        addr = ::mmap(nullptr, mapLength, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      }
+      ::close(fd);
+      if (addr == MAP_FAILED) throw std::runtime_error("IsaacShmClient: cannot map " + name);
+
+      header = static_cast<IsaacShmHeader*>(addr);
+      // the version is stored last, so the rest of the header is only read once it is seen
+      const bool valid = header->version.load(std::memory_order_acquire) == kShmVersion &&
+                         std::memcmp(header->magic, detail::kShmMagic, sizeof(header->magic)) == 0;
+      if (!valid || header->slots < 2 || detail::shmSize(header->slots) > mapLength) {
+        ::munmap(addr, mapLength);
+        throw std::runtime_error("IsaacShmClient: " + name + " is not an Isaac ring");
+      }
+      ring = detail::shmSlots(header);
+    }
+
+    IsaacShmClient(const IsaacShmClient&) = delete;
+    IsaacShmClient& operator=(const IsaacShmClient&) = delete;
+    ~IsaacShmClient() { ::munmap(header, mapLength); }
+
+    result_type operator()() {
+      if (cur == end) lease();
+      return *cur++;
+    }
+
+    void generate(result_type* dest, std::size_t n) {
+      while (n > 0) {
+        if (cur == end) lease();
+        std::size_t take = std::min(n, static_cast<std::size_t>(end - cur));
+        std::copy(cur, cur + take, dest);
+        cur += take;
+        dest += take;
+        n -= take;
+      }
+    }
+
+    void discard(unsigned long long n) {
+      for (; n > 0; n--) operator()();
+    }
+
+    // blocks leased by this client so far
+    uint64_t leases() const { return leaseCount; }
+
+   private:
+    // take the next block in the ring, waiting for the producer if it is empty
+    void lease() {
+      const uint64_t slots = header->slots;
+      detail::ShmBackoff backoff;
+      for (;;) {
+        uint64_t block = header->leased.load(std::memory_order_acquire);
+        IsaacShmSlot& slot = ring[block % slots];
+        const uint64_t seq = slot.seq.load(std::memory_order_acquire);
+        if (seq == block + 1) {
+          for (std::size_t i = 0; i < kRandSize; i++) buffer[i] = slot.data[i].load(std::memory_order_relaxed);
+          // the acq_rel exchange keeps the loads above before it, and a producer that sees it
+          // only then refills the slot, so a successful lease always holds a clean copy
+          if (header->leased.compare_exchange_strong(block, block + 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            cur = buffer;
+            end = buffer + kRandSize;
+            leaseCount++;
+            return;
+          }
+        } else if (seq < block + 1) {
+          // not produced yet
+          if (backoff.wait()) checkProducer();
+        }
+        // otherwise another client leased the block meanwhile; try the next one
+      }
+    }
+
+    void checkProducer() {
+      if (!detail::processAlive(header->producerPid.load(std::memory_order_acquire)))
+        throw std::runtime_error("IsaacShmClient: the producer has gone");
+    }
+
+    IsaacShmHeader* header;
+    IsaacShmSlot* ring;
+    std::size_t mapLength;
+    const uint32_t *cur, *end;
+    uint64_t leaseCount;
+    uint32_t buffer[kRandSize];
+  };
+}  // namespace IsaacRNG
+
+#endif
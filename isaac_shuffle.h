@@ -0,0 +1,235 @@
+#ifndef __ISAAC_SHUFFLE_H__
+#define __ISAAC_SHUFFLE_H__
+
+/**********************************************************************************
+
+  Shuffling and sampling without replacement driven directly by ISAAC output
+  blocks. These are drop-in alternatives to std::shuffle and std::sample for
+  Isaac and IsaacEngine, and a deterministic parallel merge-shuffle for arrays
+  too large to shuffle on one core.
+
+  The permutations produced are uniform but are NOT the same permutations
+  std::shuffle would produce from the same engine state.
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+  --
+
+  N.B. a C++ compiler capable of generating C++14 compliant
+  code is REQUIRED. g++ 5 will work, although g++ 6.1 or higher
+  is preferred.
+
+**********************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "isaac.h"
+#include "isaac_util.h"
+
+namespace IsaacRNG {
+  // how many swaps ahead of the current one the target element is prefetched
+  const std::size_t kShufflePrefetchDistance = 16;
+  // parallelShuffle splits arrays into power-of-two numbers of chunks no smaller than this
+  const std::size_t kMergeShuffleMinChunk = std::size_t(1) << 16;
+  const std::size_t kMergeShuffleMaxChunks = 1024;
+  // words of parent output used to seed each parallelShuffle task's own generator
+  const std::size_t kMergeShuffleSeedWords = 8;
+
+  // Fisher-Yates shuffle. Swap targets are drawn kRandSize at a time from whole output blocks
+  // and prefetched ahead of the swaps that use them.
+  template <class RandomIt, class Engine>
+  void shuffle(RandomIt first, RandomIt last, Engine& eng) {
+    using std::swap;
+    using diff_t = typename std::iterator_traits<RandomIt>::difference_type;
+
+    std::size_t n = static_cast<std::size_t>(last - first);
+    if (n < 2) return;
+
+    detail::BlockSource<Engine> src(eng);
+    std::size_t target[kRandSize];
+
+    for (std::size_t i = n - 1; i > 0;) {
+      std::size_t batch = std::min(i, kRandSize);
+      for (std::size_t t = 0; t < batch; t++) {
+        target[t] = static_cast<std::size_t>(src.bounded(i - t + 1));
+        if (t < kShufflePrefetchDistance) detail::prefetch(&first[static_cast<diff_t>(target[t])]);
+      }
+      for (std::size_t t = 0; t < batch; t++) {
+        if (t + kShufflePrefetchDistance < batch)
+          detail::prefetch(&first[static_cast<diff_t>(target[t + kShufflePrefetchDistance])]);
+        swap(first[static_cast<diff_t>(i - t)], first[static_cast<diff_t>(target[t])]);
+      }
+      i -= batch;
+    }
+  }
+
+  // Move a uniformly chosen k-subset of [first, last), in uniformly random order, to the front
+  // of the range. The rest of the range is left in an unspecified order. Returns first + k.
+  template <class RandomIt, class Engine>
+  RandomIt partialShuffle(RandomIt first, RandomIt last, std::size_t k, Engine& eng) {
+    using std::swap;
+    using diff_t = typename std::iterator_traits<RandomIt>::difference_type;
+
+    std::size_t n = static_cast<std::size_t>(last - first);
+    k = std::min(k, n);
+
+    detail::BlockSource<Engine> src(eng);
+    std::size_t target[kRandSize];
+
+    for (std::size_t i = 0; i < k;) {
+      std::size_t batch = std::min(k - i, kRandSize);
+      for (std::size_t t = 0; t < batch; t++) {
+        target[t] = i + t + static_cast<std::size_t>(src.bounded(n - i - t));
+        if (t < kShufflePrefetchDistance) detail::prefetch(&first[static_cast<diff_t>(target[t])]);
+      }
+      for (std::size_t t = 0; t < batch; t++) {
+        if (t + kShufflePrefetchDistance < batch)
+          detail::prefetch(&first[static_cast<diff_t>(target[t + kShufflePrefetchDistance])]);
+        swap(first[static_cast<diff_t>(i + t)], first[static_cast<diff_t>(target[t])]);
+      }
+      i += batch;
+    }
+
+    return first + static_cast<diff_t>(k);
+  }
+
+  // Write min(k, n) distinct indices drawn uniformly without replacement from [0, n) to out, in
+  // increasing order. Sparse samples draw indices with replacement in batches and top up after
+  // removing duplicates, so memory and draws are proportional to k rather than n.
+  template <class OutputIt, class Engine>
+  OutputIt sampleIndices(const std::size_t n, std::size_t k, OutputIt out, Engine& eng) {
+    using diff_t = std::vector<std::size_t>::difference_type;
+
+    k = std::min(k, n);
+    if (k == 0) return out;
+
+    std::vector<std::size_t> idx;
+    if (k > n / 8) {
+      idx.resize(n);
+      for (std::size_t i = 0; i < n; i++) idx[i] = i;
+      partialShuffle(idx.begin(), idx.end(), k, eng);
+      idx.resize(k);
+      std::sort(idx.begin(), idx.end());
+    } else {
+      detail::BlockSource<Engine> src(eng);
+      idx.reserve(k);
+      while (idx.size() < k) {
+        const std::size_t have = idx.size();
+        for (std::size_t i = have; i < k; i++) idx.push_back(static_cast<std::size_t>(src.bounded(n)));
+        std::sort(idx.begin() + static_cast<diff_t>(have), idx.end());
+        std::inplace_merge(idx.begin(), idx.begin() + static_cast<diff_t>(have), idx.end());
+        idx.erase(std::unique(idx.begin(), idx.end()), idx.end());
+      }
+    }
+
+    return std::copy(idx.begin(), idx.end(), out);
+  }
+
+  // As std::sample for random access input: copies min(k, n) elements chosen uniformly without
+  // replacement to out, preserving their relative order.
+  template <class RandomIt, class OutputIt, class Engine>
+  OutputIt sample(RandomIt first, RandomIt last, OutputIt out, const std::size_t k, Engine& eng) {
+    using diff_t = typename std::iterator_traits<RandomIt>::difference_type;
+
+    std::vector<std::size_t> idx;
+    sampleIndices(static_cast<std::size_t>(last - first), k, std::back_inserter(idx), eng);
+    for (std::size_t t = 0; t < idx.size(); t++) {
+      if (t + kShufflePrefetchDistance < idx.size()) detail::prefetch(&first[static_cast<diff_t>(idx[t + kShufflePrefetchDistance])]);
+      *out++ = first[static_cast<diff_t>(idx[t])];
+    }
+
+    return out;
+  }
+
+  namespace detail {
+    // MergeShuffle merge step (Bacher, Bodini, Hollender & Nicaud): given independently shuffled
+    // [first, mid) and [mid, last), leave [first, last) uniformly shuffled
+    template <class RandomIt, class Engine>
+    void mergeShuffled(RandomIt first, RandomIt mid, RandomIt last, Engine& eng) {
+      using std::swap;
+      using diff_t = typename std::iterator_traits<RandomIt>::difference_type;
+
+      const std::size_t n = static_cast<std::size_t>(last - first);
+      std::size_t i = 0, j = static_cast<std::size_t>(mid - first);
+      BlockSource<Engine> src(eng);
+      uint32_t bits = 0;
+      unsigned nbits = 0;
+
+      for (;;) {
+        if (nbits == 0) {
+          bits = src.next32();
+          nbits = 32;
+        }
+        bool takeRight = bits & 1;
+        bits >>= 1;
+        nbits--;
+        if (takeRight) {
+          if (j == n) break;
+          swap(first[static_cast<diff_t>(i)], first[static_cast<diff_t>(j)]);
+          j++;
+        } else if (i == j) {
+          break;
+        }
+        i++;
+      }
+
+      for (; i < n; i++) {
+        std::size_t m = static_cast<std::size_t>(src.bounded(i + 1));
+        swap(first[static_cast<diff_t>(i)], first[static_cast<diff_t>(m)]);
+      }
+    }
+  }  // namespace detail
+
+  // Parallel merge-shuffle. The range is cut into a power-of-two number of chunks which are
+  // shuffled independently and then merged pairwise, each level's merges running concurrently.
+  // Every chunk and merge gets its own Isaac seeded from eng, so the result depends only on
+  // the state of eng and the chunk count, never on threads or scheduling. chunks == 0 picks a
+  // count from the range length alone; ranges too small to split fall back to shuffle().
+  template <class RandomIt, class Engine>
+  void parallelShuffle(RandomIt first, RandomIt last, Engine& eng, const unsigned threads = 0, std::size_t chunks = 0) {
+    using diff_t = typename std::iterator_traits<RandomIt>::difference_type;
+
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (chunks == 0) {
+      chunks = 1;
+      while (chunks < kMergeShuffleMaxChunks && n / (chunks * 2) >= kMergeShuffleMinChunk) chunks *= 2;
+    } else {
+      std::size_t p2 = 1;
+      while (p2 * 2 <= chunks && p2 * 2 <= n) p2 *= 2;
+      chunks = p2;
+    }
+    if (chunks < 2) {
+      shuffle(first, last, eng);
+      return;
+    }
+
+    std::vector<uint32_t> seeds((2 * chunks - 1) * kMergeShuffleSeedWords);
+    eng.generate(seeds.data(), seeds.size());
+    auto taskSeed = [&seeds](const std::size_t task) { return seeds.data() + task * kMergeShuffleSeedWords; };
+    auto bound = [&](const std::size_t c) { return first + static_cast<diff_t>(n / chunks * c + n % chunks * c / chunks); };
+
+    detail::parallelFor(chunks, threads, [&](const std::size_t c) {
+      Isaac child(taskSeed(c), kMergeShuffleSeedWords);
+      shuffle(bound(c), bound(c + 1), child);
+    });
+
+    std::size_t task = chunks;
+    for (std::size_t width = 1; width < chunks; width *= 2) {
+      const std::size_t pairs = chunks / (2 * width);
+      detail::parallelFor(pairs, threads, [&, width, task](const std::size_t p) {
+        const std::size_t lo = 2 * p * width;
+        Isaac child(taskSeed(task + p), kMergeShuffleSeedWords);
+        detail::mergeShuffled(bound(lo), bound(lo + width), bound(lo + 2 * width), child);
+      });
+      task += pairs;
+    }
+  }
+}  // namespace IsaacRNG
+
+#endif
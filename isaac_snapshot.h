@@ -0,0 +1,251 @@
+#ifndef __ISAAC_SNAPSHOT_H__
+#define __ISAAC_SNAPSHOT_H__
+
+/**********************************************************************************
+
+  Cheap snapshot and rollback of ISAAC state.
+
+  Copying an Isaac costs a heap allocation and about 2 KiB of copying. A
+  SnapshotIsaac keeps its state in reference-counted blocks instead, so taking
+  an IsaacSnapshot only bumps a count and records the output position. The
+  live engine copies its state only when it is about to refill a block that a
+  snapshot still shares, and a rollback to a snapshot of the current block
+  just resets the position. Blocks are recycled, so steady snapshot and
+  rollback traffic does not allocate.
+
+  A SnapshotIsaac and its snapshots are meant for use by one thread.
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+  --
+
+  N.B. a C++ compiler capable of generating C++14 compliant
+  code is REQUIRED. g++ 5 will work, although g++ 6.1 or higher
+  is preferred.
+
+**********************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "isaac.h"
+
+namespace IsaacRNG {
+  namespace detail {
+    // the state of a SnapshotIsaac from one refill to the next
+    struct IsaacStateBlock {
+      uint32_t mem[kRandSize];
+      uint32_t rsl[kRandSize];
+      uint32_t a, b, c;
+      uint32_t refs;         // the engine, if live, plus each snapshot
+      SnapshotIsaac* owner;  // null once the engine has gone
+      IsaacStateBlock* nextFree;
+    };
+  }  // namespace detail
+
+  // A position in a SnapshotIsaac's stream. Snapshots may be copied freely and may outlive
+  // their engine, although they can only be rolled back to on the engine that took them.
+  class IsaacSnapshot {
+   public:
+    IsaacSnapshot() : blk(nullptr), cnt(0) {}
+    IsaacSnapshot(const IsaacSnapshot& snap) : blk(snap.blk), cnt(snap.cnt) {
+      if (blk != nullptr) blk->refs++;
+    }
+    IsaacSnapshot(IsaacSnapshot&& snap) noexcept : blk(std::exchange(snap.blk, nullptr)), cnt(snap.cnt) {}
+    ~IsaacSnapshot() { reset(); }
+
+    IsaacSnapshot& operator=(const IsaacSnapshot& snap) {
+      if (this != &snap) {
+        if (snap.blk != nullptr) snap.blk->refs++;
+        reset();
+        blk = snap.blk;
+        cnt = snap.cnt;
+      }
+      return *this;
+    }
+    IsaacSnapshot& operator=(IsaacSnapshot&& snap) noexcept {
+      if (this != &snap) {
+        reset();
+        blk = std::exchange(snap.blk, nullptr);
+        cnt = snap.cnt;
+      }
+      return *this;
+    }
+
+    bool empty() const { return blk == nullptr; }
+
+    // let go of the state held, after which the snapshot is empty
+    inline void reset();
+
+   private:
+    friend class SnapshotIsaac;
+
+    IsaacSnapshot(detail::IsaacStateBlock* const block, const uint32_t count) : blk(block), cnt(count) { blk->refs++; }
+
+    detail::IsaacStateBlock* blk;
+    uint32_t cnt;
+  };
+
+  // A UniformRandomBitGenerator over an Isaac stream with O(1) snapshot() and rollback().
+  class SnapshotIsaac {
+   public:
+    using result_type = uint32_t;
+    static constexpr result_type(min)() { return 0; }
+    static constexpr result_type(max)() { return UINT32_MAX; }
+
+    SnapshotIsaac() : SnapshotIsaac(Isaac()) {}
+    SnapshotIsaac(const uint32_t* const seedArr, const std::size_t seedlen) : SnapshotIsaac(Isaac(seedArr, seedlen)) {}
+    SnapshotIsaac(const char* const seedArr, const std::size_t seedlen) : SnapshotIsaac(Isaac(seedArr, seedlen)) {}
+    // continue the stream of start from where it is
+    explicit SnapshotIsaac(const Isaac& start) : freeList(nullptr) {
+      blk = acquire();
+      if (start.pending) {
+        // lazily seeded, so expand the key on a copy first
+        Isaac expanded(start);
+        expanded.settle();
+        load(expanded);
+      } else
+        load(start);
+    }
+
+    // snapshots refer back to the engine, so it stays put
+    SnapshotIsaac(const SnapshotIsaac&) = delete;
+    SnapshotIsaac& operator=(const SnapshotIsaac&) = delete;
+
+    ~SnapshotIsaac() {
+      for (detail::IsaacStateBlock* b : blocks) {
+        if (b == nullptr) continue;  // an allocation that failed
+        if (b == blk) b->refs--;
+        if (b->refs == 0)
+          delete b;
+        else
+          b->owner = nullptr;  // still held by a snapshot, which frees it
+      }
+    }
+
+    result_type operator()() {
+      if (cnt == 0) refill();
+      return blk->rsl[--cnt];
+    }
+
+    void generate(result_type* dest, std::size_t n) {
+      while (n > 0) {
+        if (cnt == 0) refill();
+        std::size_t take = std::min(n, static_cast<std::size_t>(cnt));
+        std::reverse_copy(blk->rsl + cnt - take, blk->rsl + cnt, dest);
+        cnt -= static_cast<uint32_t>(take);
+        dest += take;
+        n -= take;
+      }
+    }
+
+    void discard(unsigned long long n) {
+      while (n > cnt) {
+        n -= cnt;
+        cnt = 0;
+        refill();
+      }
+      cnt -= static_cast<uint32_t>(n);
+    }
+
+    IsaacSnapshot snapshot() { return IsaacSnapshot(blk, cnt); }
+
+    // Return to the position snap was taken at. Values drawn afterwards repeat those drawn after
+    // the snapshot was taken. Throws std::invalid_argument for an empty snapshot or one taken
+    // from a different engine.
+    void rollback(const IsaacSnapshot& snap) {
+      if (snap.blk == nullptr || snap.blk->owner != this)
+        throw std::invalid_argument("SnapshotIsaac: snapshot does not belong to this engine");
+      if (snap.blk != blk) {
+        snap.blk->refs++;
+        release(blk);
+        blk = snap.blk;
+      }
+      cnt = snap.cnt;
+    }
+
+    // an independent Isaac at the current position
+    Isaac state() const {
+      Isaac isa(kLazySeed);  // skips the randinit that the copy below would overwrite
+      std::copy(blk->mem, blk->mem + kRandSize, isa.randmem);
+      std::copy(blk->rsl, blk->rsl + kRandSize, isa.randrsl);
+      isa.randa = blk->a;
+      isa.randb = blk->b;
+      isa.randc = blk->c;
+      isa.randcnt = cnt;
+      isa.pending = false;
+      return isa;
+    }
+
+   private:
+    friend class IsaacSnapshot;
+
+    // copy the state of start into the current block
+    void load(const Isaac& start) {
+      std::copy(start.randmem, start.randmem + kRandSize, blk->mem);
+      std::copy(start.randrsl, start.randrsl + kRandSize, blk->rsl);
+      blk->a = start.randa;
+      blk->b = start.randb;
+      blk->c = start.randc;
+      cnt = start.randcnt;
+    }
+
+    // Generate the next block. Only when a snapshot shares the current block does the state move
+    // to a block of its own first; the results are about to be overwritten, so only randmem and
+    // the accumulators are copied.
+    void refill() {
+      if (blk->refs > 1) {
+        detail::IsaacStateBlock* const fresh = acquire();
+        std::copy(blk->mem, blk->mem + kRandSize, fresh->mem);
+        fresh->a = blk->a;
+        fresh->b = blk->b;
+        fresh->c = blk->c;
+        release(blk);
+        blk = fresh;
+      }
+      Isaac::isaac(blk->mem, blk->rsl, blk->a, blk->b, blk->c);
+      cnt = kRandSize;
+    }
+
+    detail::IsaacStateBlock* acquire() {
+      detail::IsaacStateBlock* b = freeList;
+      if (b != nullptr) {
+        freeList = b->nextFree;
+      } else {
+        blocks.push_back(nullptr);
+        b = blocks.back() = new detail::IsaacStateBlock;
+        b->owner = this;
+      }
+      b->refs = 1;
+      return b;
+    }
+
+    void release(detail::IsaacStateBlock* const b) {
+      if (--b->refs == 0) {
+        b->nextFree = freeList;
+        freeList = b;
+      }
+    }
+
+    detail::IsaacStateBlock* blk;
+    uint32_t cnt;
+    detail::IsaacStateBlock* freeList;
+    std::vector<detail::IsaacStateBlock*> blocks;  // every block allocated, for the destructor
+  };
+
+  inline void IsaacSnapshot::reset() {
+    if (blk == nullptr) return;
+    if (blk->owner != nullptr)
+      blk->owner->release(blk);
+    else if (--blk->refs == 0)
+      delete blk;
+    blk = nullptr;
+  }
+}  // namespace IsaacRNG
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef __ISAAC_UTIL_H__
+#define __ISAAC_UTIL_H__
+
+/**********************************************************************************
+
+  Internal helpers shared by the ISAAC samplers and adaptors: block-buffered
+  word sources, bounded integer draws and a minimal parallel loop.
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+  --
+
+  N.B. a C++ compiler capable of generating C++14 compliant
+  code is REQUIRED. g++ 5 will work, although g++ 6.1 or higher
+  is preferred.
+
+**********************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "isaac.h"
+
+namespace IsaacRNG {
+  namespace detail {
+    inline void prefetch(const void* addr) {
+#if defined(__GNUC__) || defined(__clang__)
+      __builtin_prefetch(addr, 1);
+#else
+      (void)addr;
+#endif
+    }
+
+    // one word from an Isaac or IsaacEngine, for the rare draws that fall outside a batch
+    template <class Engine>
+    uint32_t drawOne(Engine& eng) {
+      uint32_t word;
+      eng.generate(&word, 1);
+      return word;
+    }
+
+    // uniform on [0, bound) for bound > 0 using Lemire's nearly divisionless method, starting
+    // from the word first and calling next() for replacements in the rare rejected cases
+    template <class Next>
+    uint32_t bounded32(const uint32_t bound, uint32_t first, Next next) {
+      uint64_t m = static_cast<uint64_t>(first) * bound;
+      uint32_t l = static_cast<uint32_t>(m);
+      if (l < bound) {
+        uint32_t t = static_cast<uint32_t>(-bound) % bound;
+        while (l < t) {
+          m = static_cast<uint64_t>(next()) * bound;
+          l = static_cast<uint32_t>(m);
+        }
+      }
+      return static_cast<uint32_t>(m >> 32);
+    }
+
+    template <class Next>
+    uint32_t bounded32(const uint32_t bound, Next next) {
+      uint32_t first = next();
+      return bounded32(bound, first, next);
+    }
+
+    // Draws words from an Isaac or IsaacEngine a whole block at a time. Values come out in
+    // the same order as rand()/operator() would produce them, but any words left in the
+    // buffer when the source is destroyed are lost, so the engine advances by whole blocks.
+    template <class Engine>
+    class BlockSource {
+     public:
+      explicit BlockSource(Engine& engine) : eng(engine), pos(kRandSize) {}
+      BlockSource(const BlockSource&) = delete;
+      BlockSource& operator=(const BlockSource&) = delete;
+
+      uint32_t next32() {
+        if (pos == kRandSize) refill();
+        return buf[pos++];
+      }
+
+      uint64_t next64() {
+        uint64_t hi = next32();
+        return (hi << 32) | next32();
+      }
+
+      uint32_t bounded32(const uint32_t bound) { return detail::bounded32(bound, [this]() { return next32(); }); }
+
+      uint64_t bounded(const uint64_t bound) {
+        if (bound <= UINT32_MAX) return bounded32(static_cast<uint32_t>(bound));
+#ifdef __SIZEOF_INT128__
+        unsigned __int128 m = static_cast<unsigned __int128>(next64()) * bound;
+        uint64_t l = static_cast<uint64_t>(m);
+        if (l < bound) {
+          uint64_t t = (0 - bound) % bound;
+          while (l < t) {
+            m = static_cast<unsigned __int128>(next64()) * bound;
+            l = static_cast<uint64_t>(m);
+          }
+        }
+        return static_cast<uint64_t>(m >> 64);
+#else
+        uint64_t mask = bound - 1;
+        for (unsigned s = 1; s < 64; s <<= 1) mask |= mask >> s;
+        uint64_t x;
+        do {
+          x = next64() & mask;
+        } while (x >= bound);
+        return x;
+#endif
+      }
+
+     private:
+      void refill() {
+        eng.generate(buf, kRandSize);
+        pos = 0;
+      }
+
+      Engine& eng;
+      std::size_t pos;
+      uint32_t buf[kRandSize];
+    };
+
+    // run fn(0) .. fn(count - 1) over up to threads workers (0 means one per hardware thread).
+    // The calling thread takes part. Work items must be independent of one another.
+    template <class Fn>
+    void parallelFor(const std::size_t count, unsigned threads, Fn fn) {
+      if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+      if (threads > count) threads = static_cast<unsigned>(count);
+      if (threads <= 1) {
+        for (std::size_t i = 0; i < count; i++) fn(i);
+        return;
+      }
+
+      std::atomic<std::size_t> next(0);
+      auto worker = [&]() {
+        for (std::size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) fn(i);
+      };
+
+      std::vector<std::thread> pool;
+      pool.reserve(threads - 1);
+      for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+      worker();
+      for (auto& th : pool) th.join();
+    }
+  }  // namespace detail
+}  // namespace IsaacRNG
+
+#endif
@@ -0,0 +1,45 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "../../isaac_alias.h"
+#include "../../isaac_engine.h"
+#include "bench.h"
+
+int main() {
+  IsaacRNG::IsaacEngine iseng;
+  const std::size_t draws = std::size_t(1) << 22;
+  const double dd = static_cast<double>(draws);
+  std::vector<uint32_t> out(draws);
+
+  for (std::size_t n : {std::size_t(1000), std::size_t(100000), std::size_t(10000000)}) {
+    std::vector<double> weights(n);
+    for (auto &w : weights) w = static_cast<double>(iseng() >> 8) + 1.0;
+    const double dn = static_cast<double>(n);
+
+    std::cout << "discrete distribution over " << n << " weights\n";
+
+    std::discrete_distribution<uint32_t> discrete(weights.begin(), weights.end());
+    IsaacRNG::AliasTable alias;
+
+    Bench::report("  build std::discrete_distribution", dn, Bench::seconds([&]() {
+                    discrete = std::discrete_distribution<uint32_t>(weights.begin(), weights.end());
+                  }),
+                  "weight");
+    Bench::report("  build AliasTable (1 thread)", dn, Bench::seconds([&]() { alias.build(weights, 1); }), "weight");
+    Bench::report("  build AliasTable (all threads)", dn, Bench::seconds([&]() { alias.build(weights, 0); }), "weight");
+
+    Bench::report("  std::discrete_distribution", dd, Bench::seconds([&]() {
+                    for (auto &o : out) o = discrete(iseng);
+                  }),
+                  "draw");
+    Bench::report("  AliasTable::operator()", dd, Bench::seconds([&]() {
+                    for (auto &o : out) o = alias(iseng);
+                  }),
+                  "draw");
+    Bench::report("  AliasTable::sample", dd, Bench::seconds([&]() { alias.sample(iseng, out.data(), out.size()); }), "draw");
+
+    Bench::keep(out[draws / 2]);
+  }
+
+  return 0;
+}
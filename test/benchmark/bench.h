@@ -0,0 +1,48 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+/**********************************************************************************
+
+  Minimal timing harness shared by the benchmarks in this directory.
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+**********************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace Bench {
+  // defeat dead code elimination of benchmark results
+  template <class T>
+  inline void keep(const T &value) {
+    static volatile T sink;
+    sink = value;
+    (void)sink;
+  }
+
+  // run fn reps times and return the best elapsed time in seconds
+  template <class Fn>
+  double seconds(Fn fn, const int reps = 3) {
+    double best = 0.0;
+    for (int r = 0; r < reps; r++) {
+      auto start = std::chrono::steady_clock::now();
+      fn();
+      double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      if (r == 0 || secs < best) best = secs;
+    }
+    return best;
+  }
+
+  inline void report(const std::string &name, const double ops, const double secs, const std::string &unit) {
+    std::cout << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(3) << std::setw(10)
+              << secs * 1000.0 << " ms" << std::setw(14) << std::setprecision(1) << ops / secs / 1e6 << " M" << unit << "/s\n";
+  }
+}  // namespace Bench
+
+#endif
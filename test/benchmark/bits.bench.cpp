@@ -0,0 +1,71 @@
+#include <bitset>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "../../isaac_bits.h"
+#include "../../isaac_engine.h"
+#include "bench.h"
+
+int main() {
+  const std::size_t draws = std::size_t(1) << 24;
+  const double dd = static_cast<double>(draws);
+  IsaacRNG::IsaacEngine iseng(std::string("bench"));
+  IsaacRNG::BitPool<IsaacRNG::IsaacEngine> pool(iseng);
+
+  std::cout << draws << " draws\n";
+  {
+    uint32_t acc = 0;
+    Bench::report("coin: IsaacEngine() & 1", dd, Bench::seconds([&]() {
+                    for (std::size_t i = 0; i < draws; i++) acc += iseng() & 1;
+                  }),
+                  "draw");
+    std::bernoulli_distribution coin(0.5);
+    Bench::report("coin: std::bernoulli_distribution", dd, Bench::seconds([&]() {
+                    for (std::size_t i = 0; i < draws; i++) acc += coin(iseng);
+                  }),
+                  "draw");
+    Bench::report("coin: BitPool::bernoulliHalf", dd, Bench::seconds([&]() {
+                    for (std::size_t i = 0; i < draws; i++) acc += pool.bernoulliHalf();
+                  }),
+                  "draw");
+    Bench::keep(acc);
+  }
+  {
+    uint32_t acc = 0;
+    std::uniform_int_distribution<uint32_t> die(0, 5);
+    Bench::report("d6: std::uniform_int_distribution", dd, Bench::seconds([&]() {
+                    for (std::size_t i = 0; i < draws; i++) acc += die(iseng);
+                  }),
+                  "draw");
+    Bench::report("d6: BitPool::below", dd, Bench::seconds([&]() {
+                    for (std::size_t i = 0; i < draws; i++) acc += pool.below(6);
+                  }),
+                  "draw");
+    std::vector<uint32_t> out(draws);
+    Bench::report("d6: BitPool::below (batch)", dd, Bench::seconds([&]() { pool.below(6, out.data(), draws); }), "draw");
+    Bench::report("4 bits: BitPool::nextBits", dd, Bench::seconds([&]() {
+                    for (std::size_t i = 0; i < draws; i++) acc += pool.nextBits(4);
+                  }),
+                  "draw");
+    Bench::report("4 bits: BitPool::nextBits (batch)", dd, Bench::seconds([&]() { pool.nextBits(4, out.data(), draws); }), "draw");
+    Bench::keep(acc + out[draws / 2]);
+  }
+
+  std::vector<uint64_t> mask(draws / 64);
+  for (double p : {0.001, 0.3}) {
+    std::cout << "mask of " << draws << " bits, p = " << std::defaultfloat << p << "\n";
+    std::bernoulli_distribution bern(p);
+    Bench::report("  per-bit std::bernoulli_distribution", dd, Bench::seconds([&]() {
+                    for (std::size_t w = 0; w < mask.size(); w++) {
+                      uint64_t acc = 0;
+                      for (unsigned b = 0; b < 64; b++) acc |= static_cast<uint64_t>(bern(iseng)) << b;
+                      mask[w] = acc;
+                    }
+                  }),
+                  "bit");
+    Bench::report("  BitPool::fillBernoulli", dd, Bench::seconds([&]() { pool.fillBernoulli(mask.data(), draws, p); }), "bit");
+    Bench::keep(mask[mask.size() / 2]);
+  }
+
+  return 0;
+}
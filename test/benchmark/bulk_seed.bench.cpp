@@ -0,0 +1,25 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../../isaac.h"
+#include "../../isaac_bulk_seed.h"
+#include "bench.h"
+
+int main() {
+  const std::size_t engines = 4096;
+  const double de = static_cast<double>(engines);
+  std::vector<std::string> keys;
+  for (std::size_t e = 0; e < engines; e++) keys.push_back("rotation key " + std::to_string(e));
+  std::vector<IsaacRNG::Isaac> pool(engines);
+
+  std::cout << "reseeding " << engines << " engines, " << IsaacRNG::detail::kBulkSeedLanes << " lanes\n";
+  Bench::report("Isaac::seed per engine", de, Bench::seconds([&]() {
+                  for (std::size_t e = 0; e < engines; e++) pool[e].seed(keys[e].data(), keys[e].size());
+                }, 10),
+                "reseed");
+  Bench::keep(pool[engines - 1].rand());
+  Bench::report("bulkSeed", de, Bench::seconds([&]() { IsaacRNG::bulkSeed(pool.begin(), pool.end(), keys.begin()); }, 10), "reseed");
+  Bench::keep(pool[engines - 1].rand());
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "../../isaac.h"
+#include "../../isaac_ids.h"
+#include "bench.h"
+
+// Baselines draw a word per rand() call and format byte by byte.
+int main() {
+  const std::size_t ids = std::size_t(1) << 20;
+  const double di = static_cast<double>(ids);
+  const char* hex = "0123456789abcdef";
+  const char* b64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+  IsaacRNG::Isaac isa("bench", 5);
+  IsaacRNG::IdGenerator<> gen(isa);
+
+  std::cout << ids << " identifiers\n";
+  {
+    std::vector<char> out(ids * IsaacRNG::kUuidStringLength + 1);
+    Bench::report("UUIDv4 text: rand() and snprintf", di, Bench::seconds([&]() {
+                    char* o = out.data();
+                    for (std::size_t i = 0; i < ids; i++, o += IsaacRNG::kUuidStringLength) {
+                      uint32_t w0 = isa.rand(), w1 = isa.rand(), w2 = isa.rand(), w3 = isa.rand();
+                      w1 = (w1 & 0xffff0fffu) | 0x00004000u;
+                      w2 = (w2 & 0x3fffffffu) | 0x80000000u;
+                      std::snprintf(o, IsaacRNG::kUuidStringLength + 1, "%08x-%04x-%04x-%04x-%04x%08x", w0, w1 >> 16, w1 & 0xffff,
+                                    w2 >> 16, w2 & 0xffff, w3);
+                    }
+                  }),
+                  "ID");
+    Bench::report("UUIDv4 text: rand() and a hex table", di, Bench::seconds([&]() {
+                    char* o = out.data();
+                    for (std::size_t i = 0; i < ids; i++, o += IsaacRNG::kUuidStringLength) {
+                      uint8_t b[16];
+                      for (int w = 0; w < 4; w++) {
+                        uint32_t v = isa.rand();
+                        std::memcpy(b + 4 * w, &v, 4);
+                      }
+                      b[6] = static_cast<uint8_t>((b[6] & 0x0f) | 0x40);
+                      b[8] = static_cast<uint8_t>((b[8] & 0x3f) | 0x80);
+                      char* p = o;
+                      for (int k = 0; k < 16; k++) {
+                        if (k == 4 || k == 6 || k == 8 || k == 10) *p++ = '-';
+                        *p++ = hex[b[k] >> 4];
+                        *p++ = hex[b[k] & 15];
+                      }
+                    }
+                  }),
+                  "ID");
+    Bench::report("UUIDv4 text: IdGenerator::uuid4Strings", di, Bench::seconds([&]() { gen.uuid4Strings(out.data(), ids); }), "ID");
+    Bench::keep(out[ids]);
+
+    std::vector<uint8_t> bin(ids * IsaacRNG::kUuidBytes);
+    Bench::report("UUIDv4 binary: IdGenerator::uuid4", di, Bench::seconds([&]() { gen.uuid4(bin.data(), ids); }), "ID");
+    Bench::keep(bin[ids]);
+  }
+  {
+    const std::size_t bytes = 32;
+    const std::size_t width = IsaacRNG::base64UrlLength(bytes);
+    std::vector<char> out(ids * 2 * bytes);
+    Bench::report("32-byte base64url: rand() and a table", di, Bench::seconds([&]() {
+                    char* o = out.data();
+                    for (std::size_t i = 0; i < ids; i++) {
+                      uint8_t b[bytes + 2] = {};
+                      for (std::size_t w = 0; w < bytes / 4; w++) {
+                        uint32_t v = isa.rand();
+                        std::memcpy(b + 4 * w, &v, 4);
+                      }
+                      for (std::size_t k = 0; k < bytes; k += 3) {
+                        uint32_t v = static_cast<uint32_t>(b[k]) << 16 | static_cast<uint32_t>(b[k + 1]) << 8 | b[k + 2];
+                        *o++ = b64[v >> 18];
+                        *o++ = b64[(v >> 12) & 63];
+                        if (k + 1 < bytes) *o++ = b64[(v >> 6) & 63];
+                        if (k + 2 < bytes) *o++ = b64[v & 63];
+                      }
+                    }
+                  }),
+                  "ID");
+    Bench::report("32-byte base64url: IdGenerator", di, Bench::seconds([&]() { gen.base64UrlTokens(out.data(), ids, bytes); }),
+                  "ID");
+    Bench::keep(out[ids * width / 2]);
+    Bench::report("32-byte hex: IdGenerator", di, Bench::seconds([&]() { gen.hexTokens(out.data(), ids, bytes); }), "ID");
+    Bench::keep(out[ids]);
+  }
+
+  return 0;
+}
@@ -0,0 +1,67 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../../isaac.h"
+#include "bench.h"
+
+int main() {
+  const std::size_t engines = 16384;
+  const double de = static_cast<double>(engines);
+  std::vector<std::string> keys;
+  for (std::size_t e = 0; e < engines; e++) keys.push_back("session-" + std::to_string(e));
+
+  std::cout << "constructing " << engines << " engines, one per key\n";
+  Bench::report("eager", de, Bench::seconds([&]() {
+                  std::vector<IsaacRNG::Isaac> pool;
+                  pool.reserve(engines);
+                  for (const std::string& k : keys) pool.emplace_back(k.data(), k.size());
+                  Bench::keep(pool[engines - 1].rand());
+                }),
+                "engine");
+  Bench::report("lazy", de, Bench::seconds([&]() {
+                  std::vector<IsaacRNG::Isaac> pool;
+                  pool.reserve(engines);
+                  for (const std::string& k : keys) pool.emplace_back(IsaacRNG::kLazySeed, k.data(), k.size());
+                  Bench::keep(pool[engines - 1].rand());
+                }),
+                "engine");
+
+  std::cout << "constructing " << engines << " engines and drawing one value from every 16th\n";
+  Bench::report("eager", de, Bench::seconds([&]() {
+                  std::vector<IsaacRNG::Isaac> pool;
+                  pool.reserve(engines);
+                  for (const std::string& k : keys) pool.emplace_back(k.data(), k.size());
+                  uint32_t sum = 0;
+                  for (std::size_t e = 0; e < engines; e += 16) sum += pool[e].rand();
+                  Bench::keep(sum);
+                }),
+                "engine");
+  Bench::report("lazy", de, Bench::seconds([&]() {
+                  std::vector<IsaacRNG::Isaac> pool;
+                  pool.reserve(engines);
+                  for (const std::string& k : keys) pool.emplace_back(IsaacRNG::kLazySeed, k.data(), k.size());
+                  uint32_t sum = 0;
+                  for (std::size_t e = 0; e < engines; e += 16) sum += pool[e].rand();
+                  Bench::keep(sum);
+                }),
+                "engine");
+
+  const int draws = 1 << 26;
+  std::cout << "drawing " << draws << " values once seeded\n";
+  IsaacRNG::Isaac eager("key", 3);
+  IsaacRNG::Isaac lazy(IsaacRNG::kLazySeed, "key", 3);
+  Bench::report("eager", draws, Bench::seconds([&]() {
+                  uint32_t sum = 0;
+                  for (int i = 0; i < draws; i++) sum += eager.rand();
+                  Bench::keep(sum);
+                }),
+                "value");
+  Bench::report("lazy", draws, Bench::seconds([&]() {
+                  uint32_t sum = 0;
+                  for (int i = 0; i < draws; i++) sum += lazy.rand();
+                  Bench::keep(sum);
+                }),
+                "value");
+
+  return 0;
+}
@@ -0,0 +1,49 @@
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "../../isaac_engine.h"
+#include "../../isaac_pool.h"
+#include "bench.h"
+
+int main() {
+  const std::string path = "pool.bench.pool";
+  const std::size_t words = std::size_t(1) << 24;
+  const double dw = static_cast<double>(words);
+  std::vector<uint32_t> out(words);
+
+  IsaacRNG::IsaacPoolEngine::write(path, "bench", 5, words);
+  std::cout << "serving " << words << " values\n";
+
+  {
+    IsaacRNG::IsaacEngine iseng(std::string("bench"));
+    Bench::report("IsaacEngine::generate (live)", dw, Bench::seconds([&]() { iseng.generate(out.data(), words); }), "word");
+  }
+  {
+    IsaacRNG::IsaacPoolEngine pool(path);
+    Bench::report("IsaacPoolEngine::generate (pool)", dw, Bench::seconds([&]() {
+                    pool.seek(0);
+                    pool.generate(out.data(), words);
+                  }),
+                  "word");
+  }
+  {
+    IsaacRNG::IsaacEngine iseng(std::string("bench"));
+    Bench::report("IsaacEngine::operator() (live)", dw, Bench::seconds([&]() {
+                    for (auto &o : out) o = iseng();
+                  }),
+                  "word");
+  }
+  {
+    IsaacRNG::IsaacPoolEngine pool(path);
+    Bench::report("IsaacPoolEngine::operator() (pool)", dw, Bench::seconds([&]() {
+                    pool.seek(0);
+                    for (auto &o : out) o = pool();
+                  }),
+                  "word");
+  }
+
+  Bench::keep(out[words / 2]);
+  std::remove(path.c_str());
+
+  return 0;
+}
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "../../isaac_engine.h"
+#include "../../isaac_reservoir.h"
+#include "bench.h"
+
+int main() {
+  const std::size_t n = std::size_t(1) << 24;
+  const std::size_t k = 100;
+  const double dn = static_cast<double>(n);
+  std::vector<uint32_t> stream(n);
+  std::vector<double> weights(n);
+  for (std::size_t i = 0; i < n; i++) {
+    stream[i] = static_cast<uint32_t>(i);
+    weights[i] = 1.0 + static_cast<double>(i % 13);
+  }
+  IsaacRNG::IsaacEngine eng;
+
+  std::cout << "sampling " << k << " of " << n << " items\n";
+  Bench::report("Algorithm R, one draw per item", dn, Bench::seconds([&]() {
+                  std::vector<uint32_t> res(stream.begin(), stream.begin() + k);
+                  for (std::size_t i = k; i < n; i++) {
+                    const uint32_t j = IsaacRNG::detail::bounded32(static_cast<uint32_t>(i + 1), [&]() { return eng(); });
+                    if (j < k) res[j] = stream[i];
+                  }
+                  Bench::keep(res[0]);
+                }),
+                "item");
+  Bench::report("ReservoirSampler::add(item)", dn, Bench::seconds([&]() {
+                  IsaacRNG::ReservoirSampler<uint32_t> res(k, eng);
+                  for (uint32_t v : stream) res.add(v);
+                  Bench::keep(res.sample()[0]);
+                }),
+                "item");
+  Bench::report("ReservoirSampler::add(first, last)", dn, Bench::seconds([&]() {
+                  IsaacRNG::ReservoirSampler<uint32_t> res(k, eng);
+                  res.add(stream.begin(), stream.end());
+                  Bench::keep(res.sample()[0]);
+                }),
+                "item");
+
+  std::cout << "weighted sampling " << k << " of " << n << " items\n";
+  Bench::report("A-Res, one key per item", dn, Bench::seconds([&]() {
+                  using Entry = std::pair<double, uint32_t>;
+                  std::vector<Entry> heap;
+                  for (std::size_t i = 0; i < n; i++) {
+                    const double key = std::log(IsaacRNG::detail::openUniform(eng)) / weights[i];
+                    if (heap.size() < k) {
+                      heap.emplace_back(key, stream[i]);
+                      std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+                    } else if (key > heap.front().first) {
+                      std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+                      heap.back() = Entry(key, stream[i]);
+                      std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+                    }
+                  }
+                  Bench::keep(heap[0].second);
+                }),
+                "item");
+  Bench::report("WeightedReservoirSampler::add(item, w)", dn, Bench::seconds([&]() {
+                  IsaacRNG::WeightedReservoirSampler<uint32_t> res(k, eng);
+                  for (std::size_t i = 0; i < n; i++) res.add(stream[i], weights[i]);
+                  Bench::keep(res.sample()[0]);
+                }),
+                "item");
+  Bench::report("WeightedReservoirSampler::add(range)", dn, Bench::seconds([&]() {
+                  IsaacRNG::WeightedReservoirSampler<uint32_t> res(k, eng);
+                  res.add(stream.begin(), stream.end(), weights.begin());
+                  Bench::keep(res.sample()[0]);
+                }),
+                "item");
+
+  return 0;
+}
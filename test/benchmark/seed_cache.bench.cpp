@@ -0,0 +1,36 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../../isaac_engine.h"
+#include "../../isaac_seed_cache.h"
+#include "bench.h"
+
+int main() {
+  const std::size_t seeds = 200000;
+  std::vector<std::string> tenants;
+  for (auto i = 0; i < 16; i++) tenants.emplace_back("tenant key number " + std::to_string(i));
+
+  auto run = [&]() {
+    IsaacRNG::IsaacEngine iseng;
+    uint32_t acc = 0;
+    for (std::size_t i = 0; i < seeds; i++) {
+      iseng.seed(tenants[i % tenants.size()]);
+      acc ^= iseng();
+    }
+    Bench::keep(acc);
+  };
+
+  std::cout << "reseeding from " << tenants.size() << " tenant keys\n";
+
+  Bench::report("seed(std::string), cache disabled", static_cast<double>(seeds), Bench::seconds(run), "seed");
+
+  auto &cache = IsaacRNG::SeedCache::global();
+  cache.enable();
+  Bench::report("seed(std::string), cache enabled", static_cast<double>(seeds), Bench::seconds(run), "seed");
+  cache.disable();
+
+  auto st = cache.stats();
+  std::cout << "  hits " << st.hits << ", misses " << st.misses << ", entries " << st.entries << "\n";
+
+  return 0;
+}
@@ -0,0 +1,63 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "../../isaac_engine.h"
+#include "../../isaac_seed_seq.h"
+#include "bench.h"
+
+int main() {
+  const int reps = 20000;
+  const double dr = static_cast<double>(reps);
+  std::vector<uint32_t> words(IsaacRNG::kRandSize);
+  std::seed_seq stdSeq{1u, 2u, 3u, 4u};
+  IsaacRNG::IsaacSeedSeq isaacSeq{1u, 2u, 3u, 4u};
+
+  std::cout << "expanding a 4-word key to " << IsaacRNG::kRandSize << " words\n";
+  Bench::report("std::seed_seq::generate", dr, Bench::seconds([&]() {
+                  for (int r = 0; r < reps; r++) stdSeq.generate(words.begin(), words.end());
+                }),
+                "expansion");
+  Bench::keep(words[7]);
+  Bench::report("IsaacSeedSeq::generate", dr, Bench::seconds([&]() {
+                  for (int r = 0; r < reps; r++) isaacSeq.generate(words.begin(), words.end());
+                }),
+                "expansion");
+  Bench::keep(words[7]);
+
+  std::cout << "seeding an IsaacEngine\n";
+  IsaacRNG::IsaacEngine eng;
+  Bench::report("std::seed_seq via a vector", dr, Bench::seconds([&]() {
+                  for (int r = 0; r < reps; r++) {
+                    std::vector<uint32_t> tmp(IsaacRNG::kRandSize);
+                    stdSeq.generate(tmp.begin(), tmp.end());
+                    eng.seed(tmp);
+                  }
+                }),
+                "seed");
+  Bench::report("std::seed_seq directly", dr, Bench::seconds([&]() {
+                  for (int r = 0; r < reps; r++) eng.seed(stdSeq);
+                }),
+                "seed");
+  Bench::report("IsaacSeedSeq", dr, Bench::seconds([&]() {
+                  for (int r = 0; r < reps; r++) eng.seed(isaacSeq);
+                }),
+                "seed");
+  Bench::keep(eng());
+
+  const std::size_t engines = 4096;
+  const double de = static_cast<double>(engines);
+  std::vector<IsaacRNG::IsaacEngine> pool(engines);
+  std::cout << "seeding " << engines << " engines from one key\n";
+  Bench::report("std::seed_seq, one long generate", de, Bench::seconds([&]() {
+                  std::vector<uint32_t> all(engines * IsaacRNG::kRandSize);
+                  stdSeq.generate(all.begin(), all.end());
+                  for (std::size_t e = 0; e < engines; e++)
+                    pool[e].seed(std::vector<uint32_t>(all.begin() + static_cast<std::ptrdiff_t>(e * IsaacRNG::kRandSize),
+                                                       all.begin() + static_cast<std::ptrdiff_t>((e + 1) * IsaacRNG::kRandSize)));
+                }),
+                "engine");
+  Bench::report("IsaacSeedSeq::seedEngines", de, Bench::seconds([&]() { isaacSeq.seedEngines(pool.begin(), pool.end()); }), "engine");
+  Bench::keep(pool[engines - 1]());
+
+  return 0;
+}
@@ -0,0 +1,36 @@
+#include <cstdint>
+#include <vector>
+#include "../../isaac_engine.h"
+#include "../../isaac_seekable.h"
+#include "bench.h"
+
+int main() {
+  const uint64_t length = uint64_t(1) << 28;
+  const std::size_t seeks = 1000;
+  IsaacRNG::IsaacEngine iseng;
+  std::vector<uint64_t> targets(seeks);
+  for (auto &t : targets) t = (static_cast<uint64_t>(iseng()) << 32 | iseng()) % length;
+
+  std::cout << "random seeks within the first " << length << " values\n";
+
+  for (uint32_t interval : {16u, 256u, 4096u}) {
+    IsaacRNG::SeekableIsaac<> seekable(interval);
+    double first = Bench::seconds([&]() { seekable.seek(length); }, 1);
+    double secs = Bench::seconds(
+        [&]() {
+          uint32_t acc = 0;
+          for (auto t : targets) {
+            seekable.seek(t);
+            acc ^= seekable();
+          }
+          Bench::keep(acc);
+        },
+        1);
+    std::cout << "  interval " << interval << " blocks: " << seekable.checkpoints() << " checkpoints ("
+              << seekable.checkpoints() * sizeof(IsaacRNG::IsaacCheckpoint) / 1024 << " KiB), first pass "
+              << first * 1000.0 << " ms\n";
+    std::cout << "    seek + draw: " << secs / static_cast<double>(seeks) * 1e6 << " us per seek\n";
+  }
+
+  return 0;
+}
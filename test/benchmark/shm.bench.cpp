@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../../isaac_engine.h"
+#include "../../isaac_shm.h"
+#include "bench.h"
+
+// The producer runs in a child process; clients run in this process or in further children.
+namespace {
+  const std::size_t kWords = std::size_t(1) << 24;
+  const std::size_t kLatencyBlocks = 100000;
+
+  // time per call, in microseconds, at a few percentiles
+  struct Latency {
+    double p50, p99, p999, max;
+  };
+
+  // the latency of kLatencyBlocks calls of fn, each timed on its own
+  template <class Fn>
+  Latency latency(Fn fn) {
+    std::vector<double> us(kLatencyBlocks);
+    for (auto& t : us) {
+      auto start = std::chrono::steady_clock::now();
+      fn();
+      t = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+    std::sort(us.begin(), us.end());
+    auto at = [&us](const double q) { return us[static_cast<std::size_t>(q * static_cast<double>(us.size() - 1))]; };
+    return {at(0.5), at(0.99), at(0.999), us.back()};
+  }
+
+  void reportLatency(const std::string& name, const Latency& l) {
+    std::cout << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(2) << "p50 " << std::setw(7)
+              << l.p50 << "  p99 " << std::setw(7) << l.p99 << "  p99.9 " << std::setw(7) << l.p999 << "  max " << std::setw(8)
+              << l.max << " us\n";
+  }
+
+  // run fn(p) in child processes p = 0 .. procs - 1 and return the wall time until all are done
+  template <class Fn>
+  double inProcesses(const int procs, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<pid_t> kids;
+    for (int p = 0; p < procs; p++) {
+      pid_t pid = ::fork();
+      if (pid == 0) {
+        fn(p);
+        ::_exit(0);
+      }
+      kids.push_back(pid);
+    }
+    for (pid_t pid : kids) ::waitpid(pid, nullptr, 0);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+}
+
+int main() {
+  const std::string name = "/isaac_bench_" + std::to_string(::getpid());
+  IsaacRNG::IsaacShmProducer producer(name, IsaacRNG::Isaac("bench", 5));
+  pid_t feeder = ::fork();
+  if (feeder == 0) {
+    std::atomic<bool> stop(false);
+    producer.run(stop);
+    ::_exit(0);
+  }
+
+  const double dw = static_cast<double>(kWords);
+  std::vector<uint32_t> out(IsaacRNG::kRandSize);
+  std::cout << kWords << " words per client\n";
+  {
+    IsaacRNG::IsaacEngine iseng(std::string("bench"));
+    Bench::report("per-process IsaacEngine::operator()", dw, Bench::seconds([&]() {
+                    uint32_t acc = 0;
+                    for (std::size_t i = 0; i < kWords; i++) acc += iseng();
+                    Bench::keep(acc);
+                  }),
+                  "word");
+    const double blocks = dw / IsaacRNG::kRandSize;
+    Bench::report("per-process IsaacEngine, per block", blocks, Bench::seconds([&]() {
+                    for (std::size_t b = 0; b < kWords / IsaacRNG::kRandSize; b++) iseng.generate(out.data(), out.size());
+                  }),
+                  "block");
+  }
+  {
+    IsaacRNG::IsaacShmClient client(name);
+    Bench::report("IsaacShmClient::operator()", dw, Bench::seconds([&]() {
+                    uint32_t acc = 0;
+                    for (std::size_t i = 0; i < kWords; i++) acc += client();
+                    Bench::keep(acc);
+                  }),
+                  "word");
+    const double blocks = dw / IsaacRNG::kRandSize;
+    Bench::report("IsaacShmClient, per block lease", blocks, Bench::seconds([&]() {
+                    for (std::size_t b = 0; b < kWords / IsaacRNG::kRandSize; b++) client.generate(out.data(), out.size());
+                  }),
+                  "block");
+  }
+
+  const int procs = 4;
+  std::cout << procs << " client processes\n";
+  Bench::report("  each with its own IsaacEngine", procs * dw, inProcesses(procs, [&](int) {
+                  std::random_device rd;
+                  IsaacRNG::IsaacEngine iseng(rd);
+                  uint32_t acc = 0;
+                  for (std::size_t i = 0; i < kWords; i++) acc += iseng();
+                  Bench::keep(acc);
+                }),
+                "word");
+  Bench::report("  sharing the producer", procs * dw, inProcesses(procs, [&](int) {
+                  IsaacRNG::IsaacShmClient client(name);
+                  uint32_t acc = 0;
+                  for (std::size_t i = 0; i < kWords; i++) acc += client();
+                  Bench::keep(acc);
+                }),
+                "word");
+  std::cout << "  (engine construction and attachment included)\n";
+
+  // Latency of one block, alone and with every client contending for the ring. Each
+  // contending client reports its own percentiles, and the worst of them is shown.
+  std::cout << "time per " << IsaacRNG::kRandSize << "-word block, " << kLatencyBlocks << " blocks per client\n";
+  {
+    IsaacRNG::IsaacEngine iseng(std::string("bench"));
+    reportLatency("  per-process IsaacEngine::generate", latency([&]() { iseng.generate(out.data(), out.size()); }));
+    IsaacRNG::IsaacShmClient client(name);
+    reportLatency("  IsaacShmClient, one client", latency([&]() { client.generate(out.data(), out.size()); }));
+  }
+  void* shared = ::mmap(nullptr, procs * sizeof(Latency), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (shared != MAP_FAILED) {
+    Latency* results = static_cast<Latency*>(shared);
+    inProcesses(procs, [&](int p) {
+      IsaacRNG::IsaacShmClient client(name);
+      std::vector<uint32_t> block(IsaacRNG::kRandSize);
+      results[p] = latency([&]() { client.generate(block.data(), block.size()); });
+    });
+    Latency worst = results[0];
+    for (int p = 1; p < procs; p++) {
+      worst.p50 = std::max(worst.p50, results[p].p50);
+      worst.p99 = std::max(worst.p99, results[p].p99);
+      worst.p999 = std::max(worst.p999, results[p].p999);
+      worst.max = std::max(worst.max, results[p].max);
+    }
+    reportLatency("  IsaacShmClient, " + std::to_string(procs) + " contending clients", worst);
+    ::munmap(shared, procs * sizeof(Latency));
+  }
+
+  ::kill(feeder, SIGTERM);
+  ::waitpid(feeder, nullptr, 0);
+  return 0;
+}
@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "../../isaac_engine.h"
+#include "../../isaac_shuffle.h"
+#include "bench.h"
+
+// usage: shuffle.bench [log2 of element count, default 24]
+int main(int argc, char *argv[]) {
+  const unsigned bits = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 24;
+  const std::size_t n = std::size_t(1) << bits;
+  const double dn = static_cast<double>(n);
+
+  std::vector<uint32_t> vec(n);
+  std::iota(vec.begin(), vec.end(), 0);
+  IsaacRNG::IsaacEngine iseng;
+
+  std::cout << "shuffle/sample of " << n << " uint32_t elements\n";
+
+  Bench::report("std::shuffle", dn, Bench::seconds([&]() { std::shuffle(vec.begin(), vec.end(), iseng); }), "elem");
+  Bench::report("IsaacRNG::shuffle", dn, Bench::seconds([&]() { IsaacRNG::shuffle(vec.begin(), vec.end(), iseng); }), "elem");
+  Bench::report("IsaacRNG::parallelShuffle", dn,
+                Bench::seconds([&]() { IsaacRNG::parallelShuffle(vec.begin(), vec.end(), iseng); }), "elem");
+
+  const std::size_t k = n / 100;
+  std::vector<uint32_t> out(k);
+  const double dk = static_cast<double>(k);
+  // the per-draw path: partial Fisher-Yates through uniform_int_distribution
+  Bench::report("uniform_int_distribution partial F-Y (1%)", dk, Bench::seconds([&]() {
+                  for (std::size_t i = 0; i < k; i++) {
+                    std::uniform_int_distribution<std::size_t> dist(i, n - 1);
+                    std::swap(vec[i], vec[dist(iseng)]);
+                  }
+                }),
+                "sample");
+  Bench::report("IsaacRNG::sample (1%)", dk,
+                Bench::seconds([&]() { IsaacRNG::sample(vec.begin(), vec.end(), out.begin(), k, iseng); }), "sample");
+  Bench::report("IsaacRNG::partialShuffle (1%)", dk,
+                Bench::seconds([&]() { IsaacRNG::partialShuffle(vec.begin(), vec.end(), k, iseng); }), "sample");
+
+  Bench::keep(vec[n / 2]);
+  Bench::keep(out[k / 2]);
+
+  return 0;
+}
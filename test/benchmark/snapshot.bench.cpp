@@ -0,0 +1,53 @@
+#include <cstdint>
+#include <vector>
+#include "../../isaac.h"
+#include "../../isaac_snapshot.h"
+#include "bench.h"
+
+// A speculative step: save the state, draw a few values, and roll back one step in four.
+int main() {
+  const std::size_t steps = std::size_t(1) << 22;
+  const double ds = static_cast<double>(steps);
+  const int kDraws = 8;
+
+  std::cout << steps << " speculative steps of " << kDraws << " draws\n";
+  {
+    IsaacRNG::Isaac live("bench", 5);
+    uint32_t acc = 0;
+    Bench::report("Isaac copy and assign", ds, Bench::seconds([&]() {
+                    for (std::size_t s = 0; s < steps; s++) {
+                      IsaacRNG::Isaac saved(live);
+                      for (int d = 0; d < kDraws; d++) acc += live.rand();
+                      if ((s & 3) == 0) live = saved;
+                    }
+                  }),
+                  "step");
+    Bench::keep(acc);
+  }
+  {
+    IsaacRNG::SnapshotIsaac live("bench", 5);
+    uint32_t acc = 0;
+    Bench::report("SnapshotIsaac snapshot and rollback", ds, Bench::seconds([&]() {
+                    for (std::size_t s = 0; s < steps; s++) {
+                      IsaacRNG::IsaacSnapshot saved = live.snapshot();
+                      for (int d = 0; d < kDraws; d++) acc += live();
+                      if ((s & 3) == 0) live.rollback(saved);
+                    }
+                  }),
+                  "step");
+    Bench::keep(acc);
+  }
+  {
+    IsaacRNG::SnapshotIsaac live("bench", 5);
+    uint32_t acc = 0;
+    Bench::report("SnapshotIsaac without snapshots", ds, Bench::seconds([&]() {
+                    for (std::size_t s = 0; s < steps; s++) {
+                      for (int d = 0; d < kDraws; d++) acc += live();
+                    }
+                  }),
+                  "step");
+    Bench::keep(acc);
+  }
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+#ifndef __USE_MOCKRANDOM__
+#define __USE_MOCKRANDOM__
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <catch/catch.hpp>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifndef __NO_ACCESS_CONTROL__
+#define __NO_ACCESS_CONTROL__
+#define private public
+#endif
+
+#include "../../isaac.h"
+#include "../../isaac_alias.h"
+#include "../../isaac_engine.h"
+
+// probability mass each item actually receives from a built table, in units of 2^-32 columns
+static std::vector<double> tableMass(const IsaacRNG::AliasTable &alias) {
+  std::vector<double> mass(alias.size(), 0.0);
+  for (std::size_t i = 0; i < alias.size(); i++) {
+    const double keep = static_cast<double>(alias.table[i].threshold);
+    mass[i] += keep;
+    mass[alias.table[i].alias] += 4294967296.0 - keep;
+  }
+  return mass;
+}
+
+TEST_CASE("Alias table reproduces the weights (pass)", "[aliasmass]") {
+  IsaacRNG::IsaacEngine iseng;
+  std::vector<double> weights(200000);
+  for (auto &w : weights) w = std::pow(static_cast<double>(iseng()) / 4294967296.0, 4.0);
+  weights[17] = 0.0;
+
+  long double total = 0.0;
+  for (auto w : weights) total += w;
+
+  IsaacRNG::AliasTable alias(weights);
+  auto mass = tableMass(alias);
+
+  double worst = 0.0;
+  for (std::size_t i = 0; i < weights.size(); i++) {
+    long double expected = weights[i] / total * static_cast<long double>(weights.size()) * 4294967296.0L;
+    worst = std::max(worst, static_cast<double>(std::fabs(mass[i] - expected)));
+  }
+
+  REQUIRE(worst < 4.0);
+  REQUIRE(mass[17] < 1.0);
+}
+
+TEST_CASE("Alias table build does not depend on thread count (pass)", "[aliasparallel]") {
+  IsaacRNG::IsaacEngine iseng;
+  std::vector<double> weights(300000);
+  for (auto &w : weights) w = static_cast<double>(iseng() % 1000);
+
+  IsaacRNG::AliasTable serial(weights, 1);
+  IsaacRNG::AliasTable parallel(weights, 4);
+
+  bool matches = true;
+  for (std::size_t i = 0; i < weights.size(); i++) {
+    matches &= (serial.table[i].threshold == parallel.table[i].threshold);
+    matches &= (serial.table[i].alias == parallel.table[i].alias);
+  }
+
+  REQUIRE(matches);
+}
+
+TEST_CASE("Alias sampling matches the distribution (pass)", "[aliasfreq]") {
+  IsaacRNG::IsaacEngine iseng;
+  IsaacRNG::AliasTable alias = {1.0, 2.0, 0.0, 3.0, 4.0};
+
+  std::vector<uint32_t> draws(1000000);
+  alias.sample(iseng, draws.data(), draws.size());
+
+  std::vector<int> counts(5, 0);
+  for (auto d : draws) counts[d]++;
+
+  REQUIRE(counts[2] == 0);
+  for (auto i : {0, 1, 3, 4}) {
+    double expected = (i < 2 ? i + 1 : i) * 100000.0;
+    REQUIRE(std::fabs(counts[static_cast<std::size_t>(i)] - expected) < 2000.0);
+  }
+}
+
+TEST_CASE("Batch sampling matches single draws (pass)", "[aliasbatch]") {
+  for (std::size_t n : {10, 100000}) {
+    std::vector<double> weights(n);
+    for (std::size_t i = 0; i < n; i++) weights[i] = static_cast<double>(i % 7 + 1);
+    IsaacRNG::AliasTable alias(weights);
+
+    IsaacRNG::IsaacEngine isa, isb;
+    std::vector<uint32_t> batch(1000);
+    alias.sample(isa, batch.data(), batch.size());
+
+    bool matches = true;
+    for (auto v : batch) matches &= (v == alias(isb));
+
+    REQUIRE(matches);
+    REQUIRE((isa == isb));
+  }
+}
+
+TEST_CASE("Alias table rejects bad weights (fail)", "[aliasbad]") {
+  REQUIRE_THROWS_AS(IsaacRNG::AliasTable(std::vector<double>()), std::invalid_argument);
+  REQUIRE_THROWS_AS(IsaacRNG::AliasTable({0.0, 0.0}), std::invalid_argument);
+  REQUIRE_THROWS_AS(IsaacRNG::AliasTable({1.0, -1.0}), std::invalid_argument);
+  REQUIRE_THROWS_AS(IsaacRNG::AliasTable({1.0, NAN}), std::invalid_argument);
+}
+
+TEST_CASE("Alias table refuses draws before it is built (fail)", "[aliasempty]") {
+  IsaacRNG::IsaacEngine eng;
+  IsaacRNG::AliasTable alias;
+  uint32_t out[4];
+  REQUIRE_THROWS_AS(alias(eng), std::logic_error);
+  REQUIRE_THROWS_AS(alias.sample(eng, out, 4), std::logic_error);
+  alias.build({1.0, 3.0});
+  REQUIRE(alias(eng) < 2);
+}
@@ -0,0 +1,116 @@
+#ifndef __USE_MOCKRANDOM__
+#define __USE_MOCKRANDOM__
+#endif
+
+#include <bitset>
+#include <catch/catch.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "../../isaac.h"
+#include "../../isaac_bits.h"
+#include "../../isaac_engine.h"
+
+namespace {
+  std::size_t popcount(const std::vector<uint64_t>& words) {
+    std::size_t n = 0;
+    for (auto w : words) n += std::bitset<64>(w).count();
+    return n;
+  }
+}
+
+TEST_CASE("Bit pool splits the word stream into bits (pass)", "[bits]") {
+  IsaacRNG::Isaac isa("bit pool", 8);
+  IsaacRNG::Isaac isb("bit pool", 8);
+  IsaacRNG::BitPool<> pool(isa);
+
+  // bits come out least significant first, words in stream order
+  std::vector<uint32_t> words(2000);
+  isb.generate(words.data(), words.size());
+
+  bool matches = true;
+  for (std::size_t i = 0; i < 100; i++) {
+    uint32_t w = 0;
+    for (unsigned b = 0; b < 32; b++) w |= static_cast<uint32_t>(pool.bernoulliHalf()) << b;
+    matches &= (w == words[i]);
+  }
+  REQUIRE(matches);
+
+  // k-bit values that straddle register refills reassemble the same stream
+  uint64_t acc = 0;
+  unsigned held = 0;
+  std::size_t next = 100;
+  for (unsigned i = 0; i < 2000; i++) {
+    const unsigned k = 1 + i % 32;
+    uint64_t v = pool.nextBits(k);
+    matches &= (v >> k) == 0;
+    acc |= v << held;
+    held += k;
+    while (held >= 32) {
+      matches &= (static_cast<uint32_t>(acc) == words[next++]);
+      acc >>= 32;
+      held -= 32;
+    }
+  }
+  REQUIRE(matches);
+}
+
+TEST_CASE("Bit pool small-range draws are in range and balanced (pass)", "[bitsrange]") {
+  IsaacRNG::IsaacEngine iseng(std::string("dice"));
+  IsaacRNG::BitPool<IsaacRNG::IsaacEngine> pool(iseng);
+
+  const int kDraws = 60000;
+  std::vector<int> counts(6);
+  bool inRange = true;
+  for (int i = 0; i < kDraws; i++) {
+    uint32_t face = pool.below(6);
+    inRange &= face < 6;
+    if (face < 6) counts[face]++;
+  }
+  REQUIRE(inRange);
+  for (auto c : counts) REQUIRE((c > 9500 && c < 10500));
+  REQUIRE(pool.below(1) == 0);
+}
+
+TEST_CASE("Bernoulli fills have the requested density (pass)", "[bitsbernoulli]") {
+  IsaacRNG::Isaac isa("bernoulli", 9);
+  IsaacRNG::BitPool<> pool(isa);
+
+  const std::size_t nbits = 1000003;
+  std::vector<uint64_t> words((nbits + 63) / 64);
+  for (double p : {0.0, 0.001, 0.05, 0.25, 0.3, 0.5, 0.9, 0.999, 1.0}) {
+    pool.fillBernoulli(words.data(), nbits, p);
+    double expected = p * static_cast<double>(nbits);
+    double ones = static_cast<double>(popcount(words));
+    // within six standard deviations, plus a little slack for the degenerate cases
+    REQUIRE(std::abs(ones - expected) <= 6.0 * std::sqrt(expected * (1.0 - p)) + 1.0);
+    // bits past nbits stay clear
+    REQUIRE((words.back() >> (nbits % 64)) == 0);
+  }
+
+  std::bitset<1000> bs;
+  pool.fillBernoulli(bs, 1.0);
+  REQUIRE(bs.all());
+  pool.fillBernoulli(bs, 0.01);
+  REQUIRE(bs.count() < 50);
+}
+
+TEST_CASE("Bit pool batch draws match single draws (pass)", "[bitsbatch]") {
+  IsaacRNG::Isaac isa("batch", 5);
+  IsaacRNG::Isaac isb("batch", 5);
+  IsaacRNG::BitPool<> single(isa);
+  IsaacRNG::BitPool<> batch(isb);
+
+  std::vector<uint32_t> out(3000);
+  bool matches = true;
+  for (unsigned k : {3u, 7u, 32u}) {
+    batch.nextBits(k, out.data(), out.size());
+    for (auto v : out) matches &= (v == single.nextBits(k));
+  }
+  for (uint32_t n : {1u, 6u, 100u, 1000u, 4000000000u}) {
+    batch.below(n, out.data(), out.size());
+    for (auto v : out) matches &= (v == single.below(n));
+  }
+  REQUIRE(matches);
+  REQUIRE(batch() == single());
+}
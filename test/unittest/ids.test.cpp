@@ -0,0 +1,117 @@
+#ifndef __USE_MOCKRANDOM__
+#define __USE_MOCKRANDOM__
+#endif
+
+#include <catch/catch.hpp>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../../isaac.h"
+#include "../../isaac_engine.h"
+#include "../../isaac_ids.h"
+
+namespace {
+  // the byte stream IdGenerator draws from: output words in host byte order
+  std::vector<uint8_t> streamBytes(const char* seed, std::size_t words) {
+    IsaacRNG::Isaac isa(seed, std::strlen(seed));
+    std::vector<uint32_t> w(words);
+    isa.generate(w.data(), w.size());
+    std::vector<uint8_t> bytes(words * 4);
+    std::memcpy(bytes.data(), w.data(), bytes.size());
+    return bytes;
+  }
+
+  std::string hexOf(const uint8_t* p, std::size_t n) {
+    std::string s;
+    for (std::size_t i = 0; i < n; i++) {
+      s += "0123456789abcdef"[p[i] >> 4];
+      s += "0123456789abcdef"[p[i] & 15];
+    }
+    return s;
+  }
+
+  std::string base64UrlOf(const uint8_t* p, std::size_t n) {
+    const char* digits = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    std::string s;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      acc = acc << 8 | p[i];
+      bits += 8;
+      while (bits >= 6) s += digits[(acc >> (bits -= 6)) & 63];
+    }
+    if (bits > 0) s += digits[(acc << (6 - bits)) & 63];
+    return s;
+  }
+}
+
+TEST_CASE("UUIDs take consecutive stream bytes and carry version 4 (pass)", "[ids]") {
+  const std::vector<uint8_t> bytes = streamBytes("uuid", 2048);
+  IsaacRNG::Isaac isa("uuid", 4);
+  IsaacRNG::IdGenerator<> gen(isa);
+
+  const std::size_t n = 300;  // spans several blocks
+  std::vector<uint8_t> ids(n * IsaacRNG::kUuidBytes);
+  gen.uuid4(ids.data(), n);
+
+  bool matches = true;
+  for (std::size_t i = 0; i < n; i++) {
+    uint8_t want[16];
+    std::memcpy(want, &bytes[i * 16], 16);
+    want[6] = static_cast<uint8_t>((want[6] & 0x0f) | 0x40);
+    want[8] = static_cast<uint8_t>((want[8] & 0x3f) | 0x80);
+    matches &= std::memcmp(want, &ids[i * 16], 16) == 0;
+  }
+  REQUIRE(matches);
+
+  std::vector<char> text(2 * IsaacRNG::kUuidStringLength);
+  gen.uuid4Strings(text.data(), 2);
+  std::string first(text.data(), IsaacRNG::kUuidStringLength);
+  std::string hex = hexOf(&bytes[n * 16], 16);
+  hex[12] = '4';
+  hex[16] = "89ab"[(bytes[n * 16 + 8] >> 4) & 3];
+  REQUIRE(first == hex.substr(0, 8) + "-" + hex.substr(8, 4) + "-" + hex.substr(12, 4) + "-" + hex.substr(16, 4) + "-" +
+                       hex.substr(20));
+  REQUIRE(text[IsaacRNG::kUuidStringLength + 14] == '4');
+}
+
+TEST_CASE("Tokens encode the stream bytes exactly (pass)", "[idstokens]") {
+  const std::vector<uint8_t> bytes = streamBytes("tokens", 4096);
+  IsaacRNG::IsaacEngine iseng(std::string("tokens"));
+  IsaacRNG::IdGenerator<IsaacRNG::IsaacEngine> gen(iseng);
+
+  std::size_t offset = 0;
+  bool matches = true;
+  for (std::size_t len : {1u, 2u, 3u, 11u, 12u, 13u, 16u, 24u, 32u, 33u, 100u, 256u}) {
+    const std::size_t count = 7;
+    std::vector<char> hex(count * 2 * len);
+    gen.hexTokens(hex.data(), count, len);
+    for (std::size_t i = 0; i < count; i++, offset += len) {
+      matches &= std::string(&hex[i * 2 * len], 2 * len) == hexOf(&bytes[offset], len);
+    }
+
+    const std::size_t width = IsaacRNG::base64UrlLength(len);
+    std::vector<char> b64(count * width);
+    gen.base64UrlTokens(b64.data(), count, len);
+    for (std::size_t i = 0; i < count; i++, offset += len) {
+      matches &= std::string(&b64[i * width], width) == base64UrlOf(&bytes[offset], len);
+    }
+
+    std::vector<uint8_t> raw(count * len);
+    gen.nonces(raw.data(), count, len);
+    matches &= std::memcmp(raw.data(), &bytes[offset], raw.size()) == 0;
+    offset += raw.size();
+  }
+  REQUIRE(matches);
+}
+
+TEST_CASE("Token lengths out of range are rejected (fail)", "[idsbad]") {
+  IsaacRNG::Isaac isa;
+  IsaacRNG::IdGenerator<> gen(isa);
+  char out[1024];
+  REQUIRE_THROWS_AS(gen.hexTokens(out, 1, 0), std::invalid_argument);
+  REQUIRE_THROWS_AS(gen.base64UrlTokens(out, 1, IsaacRNG::kMaxIdBytes + 1), std::invalid_argument);
+}
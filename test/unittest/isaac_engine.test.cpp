@@ -120,3 +120,44 @@ TEST_CASE("Assignment operator (fail])", "[assignbad]") {
 
   REQUIRE(!matches);
 }
+
+TEST_CASE("Bulk generate matches successive draws (pass)", "[generate]") {
+  IsaacRNG::IsaacEngine isa;
+  IsaacRNG::IsaacEngine isb;
+
+  isa.discard(3);
+  isb.discard(3);
+
+  std::vector<uint32_t> bulk(1000);
+  isb.generate(bulk.data(), bulk.size());
+
+  bool matches = true;
+
+  for (auto v : bulk) {
+    matches &= (isa() == v);
+  }
+
+  REQUIRE(matches);
+  REQUIRE((isa == isb));
+}
+
+TEST_CASE("Copies agree beyond the first block (pass)", "[copylong]") {
+  IsaacRNG::IsaacEngine isa(std::string("Sphinx of black quartz, judge my vow"));
+  isa.discard(100);
+
+  IsaacRNG::IsaacEngine isb(isa);
+  IsaacRNG::IsaacEngine isc;
+  isc = isa;
+  IsaacRNG::IsaacEngine isd(std::move(IsaacRNG::IsaacEngine(isa)));
+
+  bool matches = true;
+
+  for (auto i = 0; i < 2000; i++) {
+    auto v = isa();
+    matches &= (isb() == v);
+    matches &= (isc() == v);
+    matches &= (isd() == v);
+  }
+
+  REQUIRE(matches);
+}
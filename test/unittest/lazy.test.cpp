@@ -0,0 +1,91 @@
+#ifndef __USE_MOCKRANDOM__
+#define __USE_MOCKRANDOM__
+#endif
+
+#include <catch/catch.hpp>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../isaac.h"
+#include "../../isaac_engine.h"
+#include "../../isaac_seekable.h"
+#include "../../isaac_snapshot.h"
+
+TEST_CASE("Lazy seeding draws what eager seeding draws (pass)", "[lazy]") {
+  const uint32_t key[] = {1, 2, 3, 4, 5};
+
+  IsaacRNG::Isaac eager(key, 5);
+  IsaacRNG::Isaac lazy(IsaacRNG::kLazySeed, key, 5);
+  bool matches = true;
+  for (int i = 0; i < 1000; i++) matches &= (lazy.rand() == eager.rand());
+  REQUIRE(matches);
+  REQUIRE((lazy == eager));
+
+  // generate() is a first draw too
+  IsaacRNG::Isaac eagerText("lazy key", 8);
+  IsaacRNG::Isaac lazyText(IsaacRNG::kLazySeed, "lazy key", 8);
+  std::vector<uint32_t> a(600), b(600);
+  eagerText.generate(a.data(), a.size());
+  lazyText.generate(b.data(), b.size());
+  REQUIRE(a == b);
+
+  IsaacRNG::Isaac eagerDefault;
+  IsaacRNG::Isaac lazyDefault(IsaacRNG::kLazySeed);
+  REQUIRE(lazyDefault.rand() == eagerDefault.rand());
+
+  // reseeding lazily after drawing starts the new stream afresh
+  lazy.seed(IsaacRNG::kLazySeed, "lazy key", 8);
+  matches = true;
+  for (int i = 0; i < 600; i++) matches &= (lazy.rand() == a[static_cast<std::size_t>(i)]);
+  REQUIRE(matches);
+
+  IsaacRNG::IsaacEngine eng(std::string("engine"));
+  IsaacRNG::IsaacEngine lazyEng(IsaacRNG::kLazySeed, std::string("engine"));
+  REQUIRE((lazyEng == eng));
+  lazyEng.discard(300);
+  eng.discard(300);
+  REQUIRE(lazyEng() == eng());
+}
+
+TEST_CASE("A pending lazy seed looks like its expansion (pass)", "[lazystate]") {
+  IsaacRNG::Isaac eager("state", 5);
+  IsaacRNG::Isaac lazy(IsaacRNG::kLazySeed, "state", 5);
+
+  // comparison, stream output and copies all see the expanded state
+  REQUIRE((eager == lazy));
+  REQUIRE((lazy == eager));
+  std::ostringstream eagerOut, lazyOut;
+  eagerOut << eager;
+  lazyOut << lazy;
+  REQUIRE(lazyOut.str() == eagerOut.str());
+  std::istringstream in(lazyOut.str());
+  IsaacRNG::Isaac restored(IsaacRNG::kLazySeed);
+  in >> restored;
+  REQUIRE((restored == eager));
+
+  IsaacRNG::Isaac pending(IsaacRNG::kLazySeed, "state", 5);
+  IsaacRNG::Isaac copy(pending);
+  IsaacRNG::Isaac moved(std::move(pending));
+  const uint32_t first = eager.rand();
+  REQUIRE(copy.rand() == first);
+  REQUIRE(moved.rand() == first);
+
+  // the wrappers that read Isaac's state directly expand a lazy start first
+  IsaacRNG::Isaac ref("state", 5);
+  IsaacRNG::SnapshotIsaac snap(IsaacRNG::Isaac(IsaacRNG::kLazySeed, "state", 5));
+  IsaacRNG::SeekableIsaac<> seek(IsaacRNG::Isaac(IsaacRNG::kLazySeed, "state", 5), 2);
+  bool matches = true;
+  for (int i = 0; i < 1000; i++) {
+    const uint32_t want = ref.rand();
+    matches &= (snap() == want);
+    matches &= (seek() == want);
+  }
+  seek.seek(10);
+  IsaacRNG::Isaac again("state", 5);
+  for (int i = 0; i < 10; i++) again.rand();
+  matches &= (seek() == again.rand());
+  REQUIRE(matches);
+}
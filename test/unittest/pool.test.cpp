@@ -0,0 +1,60 @@
+#ifndef __USE_MOCKRANDOM__
+#define __USE_MOCKRANDOM__
+#endif
+
+#include <algorithm>
+#include <catch/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../../isaac.h"
+#include "../../isaac_pool.h"
+
+TEST_CASE("Pool serves the stream and continues it live (pass)", "[pool]") {
+  const std::string path = "pool.test.pool";
+  IsaacRNG::IsaacPoolEngine::write(path, "replay seed", 11, 1000);
+
+  IsaacRNG::Isaac isa("replay seed", 11);
+  std::vector<uint32_t> stream(5000);
+  isa.generate(stream.data(), stream.size());
+
+  IsaacRNG::IsaacPoolEngine pool(path);
+  REQUIRE(pool.poolSize() == 1000);
+  REQUIRE(pool.seed() == "replay seed");
+
+  std::vector<uint32_t> head(900);
+  pool.generate(head.data(), head.size());
+  REQUIRE(!pool.exhausted());
+
+  bool matches = std::equal(head.begin(), head.end(), stream.begin());
+  for (std::size_t i = 900; i < stream.size(); i++) matches &= (pool() == stream[i]);
+
+  REQUIRE(matches);
+  REQUIRE(pool.exhausted());
+  REQUIRE(pool.position() == 5000);
+
+  pool.seek(17);
+  REQUIRE(pool() == stream[17]);
+  pool.seek(3000);
+  REQUIRE(pool() == stream[3000]);
+  pool.discard(999);
+  REQUIRE(pool() == stream[4000]);
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("Pool rejects files that are not pools (fail)", "[poolbad]") {
+  const std::string path = "pool.test.pool";
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << std::string(8192, 'x');
+  }
+
+  REQUIRE_THROWS_AS(IsaacRNG::IsaacPoolEngine(path), std::runtime_error);
+  REQUIRE_THROWS_AS(IsaacRNG::IsaacPoolEngine("no such file.pool"), std::runtime_error);
+
+  std::remove(path.c_str());
+}
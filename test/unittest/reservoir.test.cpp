@@ -0,0 +1,159 @@
+#ifndef __USE_MOCKRANDOM__
+#define __USE_MOCKRANDOM__
+#endif
+
+#include <catch/catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../isaac_engine.h"
+#include "../../isaac_reservoir.h"
+
+namespace {
+  // true if every count is within tolerance of expected
+  bool near(const std::vector<int>& counts, const std::vector<double>& expected, const double tolerance) {
+    bool ok = true;
+    for (std::size_t i = 0; i < counts.size(); i++) ok &= std::abs(counts[i] - expected[i]) <= tolerance * expected[i];
+    return ok;
+  }
+}
+
+TEST_CASE("Reservoir keeps short streams whole and rejects bad sizes (pass)", "[reservoir]") {
+  IsaacRNG::IsaacEngine eng(std::string("reservoir"));
+  IsaacRNG::ReservoirSampler<int> res(8, eng);
+  for (int i = 0; i < 5; i++) res.add(i);
+  REQUIRE(res.sample() == std::vector<int>({0, 1, 2, 3, 4}));
+  REQUIRE(res.seen() == 5);
+  REQUIRE(res.capacity() == 8);
+
+  REQUIRE_THROWS_AS((IsaacRNG::ReservoirSampler<int>(0, eng)), std::invalid_argument);
+  IsaacRNG::ReservoirSampler<int> other(4, eng);
+  REQUIRE_THROWS_AS(res.merge(other), std::invalid_argument);
+  REQUIRE_THROWS_AS(res.merge(res), std::invalid_argument);
+  IsaacRNG::WeightedReservoirSampler<int> weighted(2, eng);
+  REQUIRE_THROWS_AS(weighted.add(1, -1.0), std::invalid_argument);
+  // zero weights are counted but never kept, even while the reservoir has room
+  weighted.add(2, 0.0);
+  weighted.add(3, 1.0);
+  const std::vector<double> zeroes = {0.0, 0.0};
+  const std::vector<int> more = {4, 5};
+  weighted.add(more.begin(), more.end(), zeroes.begin());
+  REQUIRE(weighted.sample() == std::vector<int>({3}));
+  REQUIRE(weighted.seen() == 4);
+}
+
+TEST_CASE("Reservoir batch ingest matches item by item ingest (pass)", "[reservoirbatch]") {
+  std::vector<int> stream(100000);
+  for (int i = 0; i < static_cast<int>(stream.size()); i++) stream[static_cast<std::size_t>(i)] = i;
+  std::vector<double> weights(stream.size());
+  for (std::size_t i = 0; i < weights.size(); i++) weights[i] = 1.0 + static_cast<double>(i % 7);
+
+  IsaacRNG::IsaacEngine e1(std::string("batch")), e2(std::string("batch")), e3(std::string("batch"));
+  IsaacRNG::ReservoirSampler<int> single(50, e1), batch(50, e2), list(50, e3);
+  for (int v : stream) single.add(v);
+  batch.add(stream.begin(), stream.begin() + 30);
+  batch.add(stream.begin() + 30, stream.end());
+  std::list<int> linked(stream.begin(), stream.end());
+  list.add(linked.begin(), linked.end());
+  REQUIRE(batch.sample() == single.sample());
+  REQUIRE(list.sample() == single.sample());
+  REQUIRE(batch.seen() == stream.size());
+
+  IsaacRNG::IsaacEngine w1(std::string("weighted")), w2(std::string("weighted"));
+  IsaacRNG::WeightedReservoirSampler<int> wsingle(50, w1), wbatch(50, w2);
+  for (std::size_t i = 0; i < stream.size(); i++) wsingle.add(stream[i], weights[i]);
+  wbatch.add(stream.begin(), stream.end(), weights.begin());
+  REQUIRE(wbatch.sample() == wsingle.sample());
+  REQUIRE(wbatch.totalWeight() == wsingle.totalWeight());
+}
+
+TEST_CASE("Reservoir samples are uniform, merged or not (pass)", "[reservoirdist]") {
+  IsaacRNG::IsaacEngine eng(std::string("uniform"));
+  const int n = 40, k = 5, trials = 20000;
+  std::vector<int> whole(n), merged(n);
+  bool counted = true;
+  for (int t = 0; t < trials; t++) {
+    IsaacRNG::ReservoirSampler<int> res(k, eng);
+    for (int i = 0; i < n; i++) res.add(i);
+    for (int v : res.sample()) whole[static_cast<std::size_t>(v)]++;
+
+    // uneven halves, one of them too short to fill its reservoir
+    IsaacRNG::ReservoirSampler<int> a(k, eng), b(k, eng);
+    for (int i = 0; i < n; i++) (i < 3 ? a : b).add(i);
+    b.merge(a);
+    counted &= b.seen() == static_cast<uint64_t>(n);
+    for (int v : b.sample()) merged[static_cast<std::size_t>(v)]++;
+  }
+  REQUIRE(counted);
+  const std::vector<double> expected(n, static_cast<double>(trials) * k / n);
+  REQUIRE(near(whole, expected, 0.1));
+  REQUIRE(near(merged, expected, 0.1));
+
+  // items arriving after a merge are sampled at the right rate too
+  std::vector<int> later(n);
+  for (int t = 0; t < trials; t++) {
+    IsaacRNG::ReservoirSampler<int> a(k, eng), b(k, eng);
+    for (int i = 0; i < 10; i++) a.add(i);
+    for (int i = 10; i < 20; i++) b.add(i);
+    a.merge(b);
+    for (int i = 20; i < n; i++) a.add(i);
+    for (int v : a.sample()) later[static_cast<std::size_t>(v)]++;
+  }
+  REQUIRE(near(later, expected, 0.1));
+}
+
+TEST_CASE("Weighted reservoir follows the weights, merged or not (pass)", "[reservoirweighted]") {
+  IsaacRNG::IsaacEngine eng(std::string("weights"));
+  const std::vector<double> weights = {1.0, 2.0, 0.0, 7.0};
+  const int trials = 20000;
+  std::vector<int> whole(4), merged(4);
+  for (int t = 0; t < trials; t++) {
+    IsaacRNG::WeightedReservoirSampler<int> res(1, eng);
+    for (int i = 0; i < 4; i++) res.add(i, weights[static_cast<std::size_t>(i)]);
+    whole[static_cast<std::size_t>(res.sample()[0])]++;
+
+    IsaacRNG::WeightedReservoirSampler<int> a(1, eng), b(1, eng);
+    a.add(0, 1.0);
+    a.add(1, 2.0);
+    b.add(2, 0.0);
+    b.add(3, 7.0);
+    a.merge(b);
+    merged[static_cast<std::size_t>(a.sample()[0])]++;
+  }
+  REQUIRE(whole[2] == 0);
+  REQUIRE(merged[2] == 0);
+  whole.erase(whole.begin() + 2);
+  merged.erase(merged.begin() + 2);
+  const std::vector<double> expected = {0.1 * trials, 0.2 * trials, 0.7 * trials};
+  REQUIRE(near(whole, expected, 0.1));
+  REQUIRE(near(merged, expected, 0.1));
+}
+
+TEST_CASE("Per-thread reservoirs merge into one sample (pass)", "[reservoirthreads]") {
+  const int threads = 4, perThread = 250000;
+  std::vector<IsaacRNG::IsaacEngine> engines;
+  for (int t = 0; t < threads; t++) engines.emplace_back(std::string("thread ") + std::to_string(t));
+  std::vector<IsaacRNG::ReservoirSampler<int>> parts;
+  for (int t = 0; t < threads; t++) parts.emplace_back(100, engines[static_cast<std::size_t>(t)]);
+
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; t++)
+    pool.emplace_back([&parts, t, perThread]() {
+      for (int i = 0; i < perThread; i++) parts[static_cast<std::size_t>(t)].add(t * perThread + i);
+    });
+  for (auto& th : pool) th.join();
+  for (int t = 1; t < threads; t++) parts[0].merge(parts[static_cast<std::size_t>(t)]);
+
+  REQUIRE(parts[0].size() == 100);
+  REQUIRE(parts[0].seen() == static_cast<uint64_t>(threads) * perThread);
+  std::vector<int> fromThread(threads);
+  for (int v : parts[0].sample()) fromThread[static_cast<std::size_t>(v / perThread)]++;
+  bool everyThread = true;
+  for (int c : fromThread) everyThread &= c > 0;
+  REQUIRE(everyThread);
+}
@@ -0,0 +1,120 @@
+#ifndef __USE_MOCKRANDOM__
+#define __USE_MOCKRANDOM__
+#endif
+
+#include <algorithm>
+#include <catch/catch.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../isaac_engine.h"
+#include "../../isaac_seed_cache.h"
+
+static std::vector<uint32_t> firstValues(IsaacRNG::IsaacEngine &iseng, const std::size_t n) {
+  std::vector<uint32_t> out(n);
+  iseng.generate(out.data(), n);
+  return out;
+}
+
+TEST_CASE("Seed cache hits give the uncached sequence (pass)", "[seedcache]") {
+  auto &cache = IsaacRNG::SeedCache::global();
+  cache.clear();
+  cache.resetStats();
+
+  const std::string key("Sphinx of black quartz, judge my vow");
+  IsaacRNG::IsaacEngine plain(key);
+  auto expected = firstValues(plain, 1000);
+
+  cache.enable();
+  IsaacRNG::IsaacEngine miss(key);
+  IsaacRNG::IsaacEngine hit(key);
+  IsaacRNG::IsaacEngine reseeded;
+  reseeded.seed(key);
+  cache.disable();
+
+  REQUIRE(firstValues(miss, 1000) == expected);
+  REQUIRE(firstValues(hit, 1000) == expected);
+  REQUIRE(firstValues(reseeded, 1000) == expected);
+
+  auto st = cache.stats();
+  REQUIRE(st.hits == 2);
+  REQUIRE(st.misses == 1);
+  REQUIRE(st.entries == 1);
+
+  cache.clear();
+}
+
+TEST_CASE("Disabled seed cache is not consulted (pass)", "[seedcacheoff]") {
+  auto &cache = IsaacRNG::SeedCache::global();
+  cache.clear();
+  cache.resetStats();
+
+  IsaacRNG::IsaacEngine iseng(std::string("key"));
+  iseng.seed(std::string("key"));
+
+  auto st = cache.stats();
+  REQUIRE(!cache.enabled());
+  REQUIRE(st.hits == 0);
+  REQUIRE(st.misses == 0);
+  REQUIRE(st.entries == 0);
+}
+
+TEST_CASE("Seed cache stays within capacity (pass)", "[seedcachebound]") {
+  auto &cache = IsaacRNG::SeedCache::global();
+  cache.clear();
+  cache.resetStats();
+  cache.setCapacity(32);
+  cache.enable();
+
+  for (auto i = 0; i < 1000; i++) IsaacRNG::IsaacEngine iseng("tenant-" + std::to_string(i));
+
+  cache.disable();
+  auto st = cache.stats();
+  REQUIRE(st.entries <= 32);
+  REQUIRE(st.evictions == 1000 - st.entries);
+
+  // the bound is on the whole cache, not on each shard
+  cache.setCapacity(1);
+  REQUIRE(cache.stats().entries == 1);
+  cache.enable();
+  for (auto i = 0; i < 50; i++) IsaacRNG::IsaacEngine iseng("tenant-" + std::to_string(i));
+  cache.setCapacity(17);
+  for (auto i = 0; i < 50; i++) IsaacRNG::IsaacEngine iseng("tenant-" + std::to_string(i));
+  cache.disable();
+  REQUIRE(cache.stats().entries == 17);
+
+  cache.setCapacity(IsaacRNG::kDefaultSeedCacheCapacity);
+  cache.clear();
+  REQUIRE(cache.stats().entries == 0);
+}
+
+TEST_CASE("Seed cache is safe to share between threads (pass)", "[seedcachethreads]") {
+  auto &cache = IsaacRNG::SeedCache::global();
+  cache.clear();
+
+  std::vector<std::vector<uint32_t>> expected;
+  for (auto k = 0; k < 8; k++) {
+    IsaacRNG::IsaacEngine iseng("tenant-" + std::to_string(k));
+    expected.emplace_back(firstValues(iseng, 300));
+  }
+  cache.enable();
+
+  std::vector<char> ok(4, 1);
+  std::vector<std::thread> pool;
+  for (auto t = 0; t < 4; t++) {
+    pool.emplace_back([&, t]() {
+      for (auto i = 0; i < 400; i++) {
+        auto k = (i + t) % 8;
+        IsaacRNG::IsaacEngine iseng("tenant-" + std::to_string(k));
+        if (firstValues(iseng, 300) != expected[static_cast<std::size_t>(k)]) ok[static_cast<std::size_t>(t)] = 0;
+      }
+    });
+  }
+  for (auto &th : pool) th.join();
+  cache.disable();
+
+  REQUIRE(std::all_of(ok.begin(), ok.end(), [](char c) { return c == 1; }));
+  REQUIRE(cache.stats().entries == 8);
+  cache.clear();
+}
@@ -0,0 +1,94 @@
+#ifndef __USE_MOCKRANDOM__
+#define __USE_MOCKRANDOM__
+#endif
+
+#include <algorithm>
+#include <catch/catch.hpp>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "../../isaac.h"
+#include "../../isaac_engine.h"
+#include "../../isaac_seed_seq.h"
+
+namespace {
+  // the least a SeedSequence has to offer: generate() over a range of 32-bit words
+  struct CountingSeq {
+    uint32_t start;
+    template <class It>
+    void generate(It first, It last) {
+      for (uint32_t v = start; first != last; ++first) *first = v++;
+    }
+  };
+}
+
+TEST_CASE("Engines seed from any seed sequence (pass)", "[seedseq]") {
+  CountingSeq seq{7};
+  std::vector<uint32_t> words(IsaacRNG::kRandSize);
+  seq.generate(words.begin(), words.end());
+
+  IsaacRNG::Isaac viaVector(words.data(), words.size());
+  IsaacRNG::Isaac viaSeq(seq);
+  REQUIRE((viaSeq == viaVector));
+
+  IsaacRNG::IsaacEngine engVector(words);
+  IsaacRNG::IsaacEngine engSeq(seq);
+  REQUIRE((engSeq == engVector));
+  engSeq();
+  engSeq.seed(seq);
+  REQUIRE((engSeq == engVector));
+
+  // a non-const engine still copies rather than being taken for a seed sequence
+  IsaacRNG::IsaacEngine copy(engSeq);
+  REQUIRE((copy == engSeq));
+  std::random_device rd;
+  IsaacRNG::IsaacEngine fromDevice(rd);
+  fromDevice.seed(rd);
+}
+
+TEST_CASE("IsaacSeedSeq streams are consistent at any offset (pass)", "[seedseqstream]") {
+  IsaacRNG::IsaacSeedSeq seq{1u, 2u, 3u};
+  REQUIRE(seq.size() == 3);
+  std::vector<uint32_t> key;
+  seq.param(std::back_inserter(key));
+  REQUIRE(key == std::vector<uint32_t>({1, 2, 3}));
+
+  std::vector<uint32_t> all(4 * IsaacRNG::kRandSize);
+  seq.generate(all.begin(), all.end());
+  bool matches = true;
+  for (uint64_t offset : {0u, 1u, 2u, 255u, 256u, 513u}) {
+    std::vector<uint32_t> part(101);
+    seq.generate(part.begin(), part.end(), offset);
+    matches &= std::equal(part.begin(), part.end(), all.begin() + static_cast<std::ptrdiff_t>(offset));
+  }
+  REQUIRE(matches);
+
+  std::vector<IsaacRNG::IsaacEngine> engines(3);
+  seq.seedEngines(engines.begin(), engines.end());
+  for (std::size_t e = 0; e < engines.size(); e++) {
+    IsaacRNG::IsaacEngine want(std::vector<uint32_t>(all.begin() + static_cast<std::ptrdiff_t>(e * IsaacRNG::kRandSize),
+                                                     all.begin() + static_cast<std::ptrdiff_t>((e + 1) * IsaacRNG::kRandSize)));
+    REQUIRE((engines[e] == want));
+  }
+  REQUIRE((engines[0] != engines[1]));
+}
+
+TEST_CASE("IsaacSeedSeq keys give distinct streams (pass)", "[seedseqkeys]") {
+  std::vector<uint32_t> longKey(300, 5);
+  IsaacRNG::IsaacSeedSeq a(longKey.begin(), longKey.end());
+  longKey[299] = 6;
+  IsaacRNG::IsaacSeedSeq b(longKey.begin(), longKey.end());
+  IsaacRNG::IsaacSeedSeq empty, zero{0u};
+
+  std::vector<uint32_t> wa(IsaacRNG::kRandSize), wb(IsaacRNG::kRandSize), we(IsaacRNG::kRandSize), wz(IsaacRNG::kRandSize);
+  a.generate(wa.begin(), wa.end());
+  b.generate(wb.begin(), wb.end());
+  empty.generate(we.begin(), we.end());
+  zero.generate(wz.begin(), wz.end());
+
+  std::size_t differ = 0;
+  for (std::size_t i = 0; i < wa.size(); i++) differ += wa[i] != wb[i];
+  REQUIRE(differ > 250);
+  REQUIRE(we != wz);
+}
@@ -0,0 +1,84 @@
+#ifndef __USE_MOCKRANDOM__
+#define __USE_MOCKRANDOM__
+#endif
+
+#include <algorithm>
+#include <catch/catch.hpp>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../../isaac.h"
+#include "../../isaac_seekable.h"
+
+TEST_CASE("Seekable stream matches Isaac and seeks anywhere (pass)", "[seek]") {
+  const char *const key = "This is <i>not</i> the right mytext.";
+  IsaacRNG::Isaac isa(key, 36);
+  std::vector<uint32_t> stream(100000);
+  isa.generate(stream.data(), stream.size());
+
+  IsaacRNG::SeekableIsaac<> seekable(key, 36, 8);
+  std::vector<uint32_t> head(5000);
+  seekable.generate(head.data(), head.size());
+  REQUIRE(std::equal(head.begin(), head.end(), stream.begin()));
+  REQUIRE(seekable.position() == 5000);
+
+  bool matches = true;
+  for (uint64_t pos : {99000, 0, 255, 256, 257, 4095, 65536, 12, 70000, 69999}) {
+    seekable.seek(pos);
+    for (uint64_t i = pos; i < std::min<uint64_t>(pos + 300, stream.size()); i++) matches &= (seekable() == stream[i]);
+  }
+
+  REQUIRE(matches);
+  REQUIRE(seekable.checkpoints() == 99000 / 256 / 8);
+}
+
+TEST_CASE("Seekable stream starts where the Isaac it was built from is (pass)", "[seekmid]") {
+  IsaacRNG::Isaac isa;
+  isa.generate(std::vector<uint32_t>(1000).data(), 1000);
+
+  IsaacRNG::SeekableIsaac<> seekable(isa, 2);
+  std::vector<uint32_t> stream(10000);
+  isa.generate(stream.data(), stream.size());
+
+  seekable.seek(9000);
+  REQUIRE(seekable() == stream[9000]);
+  seekable.seek(3);
+  REQUIRE(seekable() == stream[3]);
+  seekable.discard(996);
+  REQUIRE(seekable() == stream[1000]);
+}
+
+TEST_CASE("Checkpoint file is reused by a later run (pass)", "[seekfile]") {
+  const std::string path = "seekable.test.ckp";
+  std::remove(path.c_str());
+
+  uint32_t front, back;
+  {
+    IsaacRNG::FileCheckpointStore store(path);
+    IsaacRNG::SeekableIsaac<IsaacRNG::FileCheckpointStore> seekable("key", 3, 4, store);
+    seekable.seek(50000);
+    back = seekable();
+    seekable.seek(0);
+    front = seekable();
+    REQUIRE(store.size() == 50000 / 256 / 4);
+  }
+
+  {
+    IsaacRNG::FileCheckpointStore store(path);
+    IsaacRNG::SeekableIsaac<IsaacRNG::FileCheckpointStore> seekable("key", 3, 4, store);
+    REQUIRE(store.size() == 50000 / 256 / 4);
+    seekable.seek(50000);
+    REQUIRE(seekable() == back);
+    REQUIRE(seekable.position() == 50001);
+  }
+
+  {
+    IsaacRNG::FileCheckpointStore store(path);
+    REQUIRE_THROWS_AS(IsaacRNG::SeekableIsaac<IsaacRNG::FileCheckpointStore>("other key", 9, 4, store), std::runtime_error);
+  }
+
+  REQUIRE(front == IsaacRNG::Isaac("key", 3).rand());
+  std::remove(path.c_str());
+}
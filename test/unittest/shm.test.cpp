@@ -0,0 +1,196 @@
+#ifndef __USE_MOCKRANDOM__
+#define __USE_MOCKRANDOM__
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <catch/catch.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../../isaac.h"
+#include "../../isaac_shm.h"
+
+namespace {
+  std::string ringName(const char* tag) { return std::string("/isaac_test_") + tag + "_" + std::to_string(::getpid()); }
+
+  // the block number of each block of the stream of seed, keyed on its first two words
+  std::map<std::pair<uint32_t, uint32_t>, std::size_t> blockIndex(const char* seed, std::size_t blocks) {
+    IsaacRNG::Isaac isa(seed, std::strlen(seed));
+    std::map<std::pair<uint32_t, uint32_t>, std::size_t> index;
+    std::vector<uint32_t> block(IsaacRNG::kRandSize);
+    for (std::size_t b = 0; b < blocks; b++) {
+      isa.generate(block.data(), block.size());
+      index[std::make_pair(block[0], block[1])] = b;
+    }
+    return index;
+  }
+}
+
+TEST_CASE("Clients share the producer's blocks without loss or repeats (pass)", "[shm]") {
+  const std::string name = ringName("share");
+  IsaacRNG::IsaacShmProducer producer(name, IsaacRNG::Isaac("shared", 6), 8);
+  IsaacRNG::IsaacShmClient one(name), two(name);
+
+  // a single client sees the producer's stream in order
+  IsaacRNG::Isaac isa("shared", 6);
+  bool matches = true;
+  for (int i = 0; i < 3 * 256; i++) matches &= (one() == isa.rand());
+  REQUIRE(matches);
+  producer.produce();
+
+  // clients on several threads each get whole blocks, and together get every block once
+  const std::size_t kBlocks = 4000;
+  std::atomic<bool> stop(false);
+  std::thread feeder([&]() { producer.run(stop); });
+  std::vector<std::vector<uint32_t>> got(2);
+  std::thread other([&]() {
+    for (std::size_t b = 0; b < kBlocks / 2; b++) {
+      std::vector<uint32_t> block(IsaacRNG::kRandSize);
+      two.generate(block.data(), block.size());
+      got[1].push_back(block[0]);
+      got[1].push_back(block[1]);
+    }
+  });
+  for (std::size_t b = 0; b < kBlocks / 2; b++) {
+    std::vector<uint32_t> block(IsaacRNG::kRandSize);
+    one.generate(block.data(), block.size());
+    got[0].push_back(block[0]);
+    got[0].push_back(block[1]);
+  }
+  other.join();
+  stop = true;
+  feeder.join();
+
+  const auto index = blockIndex("shared", kBlocks + 16);
+  std::vector<int> seen(kBlocks + 16);
+  bool known = true;
+  for (auto& g : got) {
+    for (std::size_t i = 0; i < g.size(); i += 2) {
+      auto it = index.find(std::make_pair(g[i], g[i + 1]));
+      known &= it != index.end();
+      if (it != index.end()) seen[it->second]++;
+    }
+  }
+  REQUIRE(known);
+  REQUIRE(std::count(seen.begin() + 3, seen.begin() + 3 + static_cast<std::ptrdiff_t>(kBlocks), 1) == static_cast<long>(kBlocks));
+  REQUIRE(one.leases() + two.leases() == kBlocks + 3);
+}
+
+TEST_CASE("The ring survives a client killed mid-lease (pass)", "[shmcrash]") {
+  const std::string name = ringName("crash");
+  IsaacRNG::IsaacShmProducer producer(name, IsaacRNG::Isaac("crash", 5), 4);
+
+  pid_t child = ::fork();
+  if (child == 0) {
+    // lease as fast as possible until killed
+    IsaacRNG::IsaacShmClient greedy(name);
+    for (;;) greedy();
+  }
+  REQUIRE(child > 0);
+
+  std::atomic<bool> stop(false);
+  std::thread feeder([&]() { producer.run(stop); });
+  while (producer.leased() < 2000) std::this_thread::yield();
+  ::kill(child, SIGKILL);
+  ::waitpid(child, nullptr, 0);
+
+  IsaacRNG::IsaacShmClient survivor(name);
+  std::vector<uint32_t> words(100 * IsaacRNG::kRandSize);
+  survivor.generate(words.data(), words.size());
+  stop = true;
+  feeder.join();
+  REQUIRE(survivor.leases() == 100);
+}
+
+TEST_CASE("Clients reject missing rings and notice a vanished producer (fail)", "[shmbad]") {
+  REQUIRE_THROWS_AS(IsaacRNG::IsaacShmClient("/isaac_test_no_such_ring"), std::runtime_error);
+  REQUIRE_THROWS_AS(IsaacRNG::IsaacShmProducer(ringName("tiny"), IsaacRNG::Isaac(), 1), std::invalid_argument);
+
+  const std::string name = ringName("gone");
+  auto producer = std::unique_ptr<IsaacRNG::IsaacShmProducer>(new IsaacRNG::IsaacShmProducer(name, IsaacRNG::Isaac(), 2));
+  IsaacRNG::IsaacShmClient orphan(name);
+  producer.reset();
+  std::vector<uint32_t> words(2 * IsaacRNG::kRandSize);
+  orphan.generate(words.data(), words.size());  // what was already produced is still served
+  REQUIRE_THROWS_AS(orphan(), std::runtime_error);
+}
+
+TEST_CASE("Producers refuse a live ring and replace a stale one (fail)", "[shmtakeover]") {
+  const std::string name = ringName("takeover");
+  {
+    IsaacRNG::IsaacShmProducer first(name, IsaacRNG::Isaac("first", 5), 4);
+    REQUIRE_THROWS_AS(IsaacRNG::IsaacShmProducer(name, IsaacRNG::Isaac("second", 6), 4), std::runtime_error);
+    IsaacRNG::IsaacShmClient client(name);
+    IsaacRNG::Isaac want("first", 5);
+    REQUIRE(client() == want.rand());
+  }
+
+  // a producer that dies without cleaning up leaves its segment behind
+  pid_t child = ::fork();
+  if (child == 0) {
+    IsaacRNG::IsaacShmProducer crashed(name, IsaacRNG::Isaac("crashed", 7), 4);
+    ::_exit(0);
+  }
+  REQUIRE(child > 0);
+  ::waitpid(child, nullptr, 0);
+  IsaacRNG::IsaacShmProducer replacement(name, IsaacRNG::Isaac("replacement", 11), 4);
+  IsaacRNG::IsaacShmClient client(name);
+  IsaacRNG::Isaac want("replacement", 11);
+  REQUIRE(client() == want.rand());
+}
+
+TEST_CASE("Producers racing for a stale ring leave exactly one live ring (pass)", "[shmrace]") {
+  const std::string name = ringName("race");
+  pid_t stale = ::fork();
+  if (stale == 0) {
+    IsaacRNG::IsaacShmProducer crashed(name, IsaacRNG::Isaac("crashed", 7), 4);
+    ::_exit(0);
+  }
+  REQUIRE(stale > 0);
+  ::waitpid(stale, nullptr, 0);
+
+  // each racer exits 0 only if it created the ring and still serves its own stream from it
+  // once every other racer has had its go
+  const auto start = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+  std::vector<pid_t> racers;
+  for (int r = 0; r < 6; r++) {
+    pid_t pid = ::fork();
+    if (pid == 0) {
+      std::this_thread::sleep_until(start);
+      const std::string seed = "racer " + std::to_string(r);
+      int status = 1;
+      try {
+        IsaacRNG::IsaacShmProducer producer(name, IsaacRNG::Isaac(seed.data(), seed.size()), 4);
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        IsaacRNG::IsaacShmClient client(name);
+        IsaacRNG::Isaac want(seed.data(), seed.size());
+        status = client() == want.rand() ? 0 : 2;
+      } catch (const std::runtime_error&) {
+      }
+      ::_exit(status);
+    }
+    racers.push_back(pid);
+  }
+  int winners = 0, lost = 0;
+  for (pid_t pid : racers) {
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0) winners++;
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 1) lost++;
+  }
+  REQUIRE(winners == 1);
+  REQUIRE(lost == 5);
+}
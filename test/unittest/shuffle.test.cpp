@@ -0,0 +1,126 @@
+#ifndef __USE_MOCKRANDOM__
+#define __USE_MOCKRANDOM__
+#endif
+
+#include <algorithm>
+#include <catch/catch.hpp>
+#include <map>
+#include <numeric>
+#include <set>
+#include <vector>
+
+#include "../../isaac_engine.h"
+#include "../../isaac_shuffle.h"
+
+TEST_CASE("Shuffle produces a permutation (pass)", "[shuffle]") {
+  IsaacRNG::IsaacEngine iseng;
+  std::vector<uint32_t> vec(10000);
+  std::iota(vec.begin(), vec.end(), 0);
+
+  IsaacRNG::shuffle(vec.begin(), vec.end(), iseng);
+
+  std::vector<uint32_t> sorted(vec);
+  std::sort(sorted.begin(), sorted.end());
+
+  REQUIRE(vec != sorted);
+  bool isPermutation = true;
+  for (uint32_t i = 0; i < sorted.size(); i++) isPermutation &= (sorted[i] == i);
+  REQUIRE(isPermutation);
+}
+
+TEST_CASE("Shuffle of three elements is uniform (pass)", "[shuffleuniform]") {
+  IsaacRNG::IsaacEngine iseng;
+  std::map<std::vector<int>, int> counts;
+
+  for (auto i = 0; i < 60000; i++) {
+    std::vector<int> vec = {0, 1, 2};
+    IsaacRNG::shuffle(vec.begin(), vec.end(), iseng);
+    counts[vec]++;
+  }
+
+  REQUIRE(counts.size() == 6);
+  for (auto &c : counts) {
+    REQUIRE(c.second > 9500);
+    REQUIRE(c.second < 10500);
+  }
+}
+
+TEST_CASE("Sampled indices are distinct and in range (pass)", "[sampleindices]") {
+  IsaacRNG::IsaacEngine iseng;
+
+  for (auto k : {0, 1, 10, 500, 1000, 5000}) {
+    std::vector<std::size_t> idx;
+    IsaacRNG::sampleIndices(1000, static_cast<std::size_t>(k), std::back_inserter(idx), iseng);
+    std::set<std::size_t> distinct(idx.begin(), idx.end());
+
+    REQUIRE(idx.size() == static_cast<std::size_t>(std::min(k, 1000)));
+    REQUIRE(distinct.size() == idx.size());
+    REQUIRE(std::is_sorted(idx.begin(), idx.end()));
+    REQUIRE((idx.empty() || idx.back() < 1000));
+  }
+}
+
+TEST_CASE("Sample preserves relative order (pass)", "[sample]") {
+  IsaacRNG::IsaacEngine iseng;
+  std::vector<int> vec(100000);
+  std::iota(vec.begin(), vec.end(), 0);
+
+  std::vector<int> out;
+  IsaacRNG::sample(vec.begin(), vec.end(), std::back_inserter(out), 100, iseng);
+
+  REQUIRE(out.size() == 100);
+  REQUIRE(std::is_sorted(out.begin(), out.end()));
+  REQUIRE(std::adjacent_find(out.begin(), out.end()) == out.end());
+}
+
+TEST_CASE("Partial shuffle picks every element equally often (pass)", "[partialshuffle]") {
+  IsaacRNG::IsaacEngine iseng;
+  std::vector<int> counts(10, 0);
+
+  for (auto i = 0; i < 50000; i++) {
+    std::vector<int> vec(10);
+    std::iota(vec.begin(), vec.end(), 0);
+    auto mid = IsaacRNG::partialShuffle(vec.begin(), vec.end(), 2, iseng);
+    for (auto it = vec.begin(); it != mid; ++it) counts[static_cast<std::size_t>(*it)]++;
+  }
+
+  for (auto c : counts) {
+    REQUIRE(c > 9500);
+    REQUIRE(c < 10500);
+  }
+}
+
+TEST_CASE("Parallel shuffle does not depend on thread count (pass)", "[parallelshuffle]") {
+  std::vector<uint32_t> a(1 << 18), b(1 << 18);
+  std::iota(a.begin(), a.end(), 0);
+  std::iota(b.begin(), b.end(), 0);
+
+  IsaacRNG::IsaacEngine isa, isb;
+  IsaacRNG::parallelShuffle(a.begin(), a.end(), isa, 1, 8);
+  IsaacRNG::parallelShuffle(b.begin(), b.end(), isb, 4, 8);
+
+  REQUIRE(a == b);
+  REQUIRE((isa == isb));
+
+  std::sort(a.begin(), a.end());
+  bool isPermutation = true;
+  for (uint32_t i = 0; i < a.size(); i++) isPermutation &= (a[i] == i);
+  REQUIRE(isPermutation);
+}
+
+TEST_CASE("Parallel shuffle merge step is uniform (pass)", "[mergeshuffle]") {
+  IsaacRNG::IsaacEngine iseng;
+  std::map<std::vector<int>, int> counts;
+
+  for (auto i = 0; i < 48000; i++) {
+    std::vector<int> vec = {0, 1, 2, 3};
+    IsaacRNG::parallelShuffle(vec.begin(), vec.end(), iseng, 1, 4);
+    counts[vec]++;
+  }
+
+  REQUIRE(counts.size() == 24);
+  for (auto &c : counts) {
+    REQUIRE(c.second > 1700);
+    REQUIRE(c.second < 2300);
+  }
+}
@@ -0,0 +1,83 @@
+#ifndef __USE_MOCKRANDOM__
+#define __USE_MOCKRANDOM__
+#endif
+
+#include <catch/catch.hpp>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "../../isaac.h"
+#include "../../isaac_snapshot.h"
+
+TEST_CASE("Snapshot engine follows the Isaac stream (pass)", "[snapshot]") {
+  IsaacRNG::Isaac isa("snapshot", 8);
+  IsaacRNG::SnapshotIsaac snap("snapshot", 8);
+
+  bool matches = true;
+  for (int i = 0; i < 1000; i++) matches &= (snap() == isa.rand());
+  std::vector<uint32_t> a(700), b(700);
+  isa.generate(a.data(), a.size());
+  snap.generate(b.data(), b.size());
+  matches &= (a == b);
+  isa.generate(a.data(), 300);
+  snap.discard(299);
+  matches &= (snap() == a[299]);
+  REQUIRE(matches);
+
+  IsaacRNG::Isaac copy = snap.state();
+  REQUIRE((copy == isa));
+}
+
+TEST_CASE("Rollback replays the stream within and across blocks (pass)", "[snapshotrollback]") {
+  IsaacRNG::Isaac isa("rollback", 8);
+  std::vector<uint32_t> stream(5000);
+  isa.generate(stream.data(), stream.size());
+
+  IsaacRNG::SnapshotIsaac eng("rollback", 8);
+  eng.discard(100);
+  IsaacRNG::IsaacSnapshot inBlock = eng.snapshot();
+
+  // rollback inside the current block
+  eng.discard(50);
+  eng.rollback(inBlock);
+  REQUIRE(eng() == stream[100]);
+
+  // rollback across several refills, more than once, with nested snapshots
+  eng.discard(1000);
+  IsaacRNG::IsaacSnapshot later = eng.snapshot();
+  eng.discard(2000);
+  bool matches = true;
+  for (int pass = 0; pass < 3; pass++) {
+    eng.rollback(inBlock);
+    for (std::size_t i = 100; i < 1500; i++) matches &= (eng() == stream[i]);
+    eng.rollback(later);
+    for (std::size_t i = 1101; i < 4000; i++) matches &= (eng() == stream[i]);
+  }
+  REQUIRE(matches);
+
+  // a copied snapshot keeps its state after the original goes
+  IsaacRNG::IsaacSnapshot kept = later;
+  later.reset();
+  REQUIRE(later.empty());
+  eng.rollback(kept);
+  REQUIRE(eng() == stream[1101]);
+}
+
+TEST_CASE("Rollback rejects foreign or empty snapshots (fail)", "[snapshotbad]") {
+  IsaacRNG::SnapshotIsaac one("one", 3), two("two", 3);
+  IsaacRNG::IsaacSnapshot empty;
+  IsaacRNG::IsaacSnapshot fromTwo = two.snapshot();
+
+  REQUIRE_THROWS_AS(one.rollback(empty), std::invalid_argument);
+  REQUIRE_THROWS_AS(one.rollback(fromTwo), std::invalid_argument);
+
+  // a snapshot that outlives its engine can no longer be rolled back to, but is safe to drop
+  IsaacRNG::IsaacSnapshot orphan;
+  {
+    IsaacRNG::SnapshotIsaac gone("gone", 4);
+    gone.discard(300);
+    orphan = gone.snapshot();
+  }
+  REQUIRE_THROWS_AS(one.rollback(orphan), std::invalid_argument);
+}
@@ -0,0 +1,58 @@
+/**********************************************************************************
+
+  Write or inspect a pre-generated ISAAC randomness pool (see isaac_pool.h).
+
+  usage: isaac_pool <pool file> <word count> [seed string]
+         isaac_pool --info <pool file>
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+**********************************************************************************/
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include "../isaac_pool.h"
+
+namespace {
+  // the word count argument, or zero if it is not a positive decimal number that fits
+  uint64_t parseCount(const char *arg) {
+    if (*arg < '0' || *arg > '9') return 0;  // strtoull would accept a sign or leading space
+    char *end = nullptr;
+    errno = 0;
+    const unsigned long long n = std::strtoull(arg, &end, 10);
+    if (errno != 0 || *end != '\0') return 0;
+    return n;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  try {
+    if (argc == 3 && std::strcmp(argv[1], "--info") == 0) {
+      IsaacRNG::IsaacPoolEngine pool(argv[2]);
+      std::cout << "words: " << pool.poolSize() << "\n";
+      std::cout << "seed:  \"" << pool.seed() << "\"\n";
+      return 0;
+    }
+
+    const uint64_t words = argc == 3 || argc == 4 ? parseCount(argv[2]) : 0;
+    if (words > 0) {
+      const std::string seed = argc == 4 ? argv[3] : "";
+      IsaacRNG::IsaacPoolEngine::write(argv[1], seed.data(), seed.length(), words);
+      return 0;
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "isaac_pool: " << e.what() << "\n";
+    return 1;
+  }
+
+  std::cerr << "usage: isaac_pool <pool file> <word count> [seed string]\n"
+            << "       isaac_pool --info <pool file>\n";
+  return 2;
+}
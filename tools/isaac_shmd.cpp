@@ -0,0 +1,57 @@
+/**********************************************************************************
+
+  Run an ISAAC shared-memory producer (see isaac_shm.h) until interrupted.
+  The generator is seeded from std::random_device.
+
+  usage: isaac_shmd <ring name> [slots]
+
+  Written by David Gillies
+
+  Released into the public domain. See LICENSE for details
+
+**********************************************************************************/
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include "../isaac_shm.h"
+
+namespace {
+  std::atomic<bool> stop(false);
+
+  void onSignal(int) { stop = true; }
+
+  // the slot count argument, or zero if it is not a positive decimal number that fits
+  uint32_t parseCount(const char *arg) {
+    if (*arg < '0' || *arg > '9') return 0;  // strtoul would accept a sign or leading space
+    char *end = nullptr;
+    errno = 0;
+    const unsigned long n = std::strtoul(arg, &end, 10);
+    if (errno != 0 || *end != '\0' || n > UINT32_MAX) return 0;
+    return static_cast<uint32_t>(n);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  const uint32_t slots = argc == 3 ? parseCount(argv[2]) : IsaacRNG::kDefaultShmSlots;
+  if ((argc != 2 && argc != 3) || slots == 0) {
+    std::cerr << "usage: isaac_shmd <ring name> [slots]\n";
+    return 2;
+  }
+
+  try {
+    IsaacRNG::IsaacShmProducer producer(argv[1], slots);
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    producer.run(stop);
+    std::cout << producer.leased() << " blocks leased\n";
+  } catch (const std::exception &e) {
+    std::cerr << "isaac_shmd: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}